@@ -0,0 +1,190 @@
+#include <new>
+#include <cstdlib>
+#include <cstdint>
+
+#include <benchmark/benchmark.h>
+
+#include <BigInteger.hpp>
+#include <BigIntegerArray.hpp>
+
+/* Every heap allocation made by the process goes through these */
+static uint64_t allocations = 0;
+
+void* operator new(std::size_t size) {
+	allocations += 1;
+	if (void* pointer = std::malloc(size)) {
+		return pointer;
+	}
+	throw std::bad_alloc();
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment) {
+	allocations += 1;
+	if (void* pointer = std::aligned_alloc(static_cast<std::size_t>(alignment), (size + static_cast<std::size_t>(alignment) - 1) &
+											~(static_cast<std::size_t>(alignment) - 1))) {
+		return pointer;
+	}
+	throw std::bad_alloc();
+}
+
+void operator delete(void* pointer) noexcept {
+	std::free(pointer);
+}
+
+void operator delete(void* pointer, std::size_t) noexcept {
+	std::free(pointer);
+}
+
+void operator delete(void* pointer, std::align_val_t) noexcept {
+	std::free(pointer);
+}
+
+void operator delete(void* pointer, std::size_t, std::align_val_t) noexcept {
+	std::free(pointer);
+}
+
+static void report_allocations(benchmark::State& state, uint64_t count) {
+	state.counters["allocations"] = benchmark::Counter(static_cast<double>(count), benchmark::Counter::kAvgIterations);
+}
+
+static void Increment(benchmark::State& state) {
+	uint64_t count = 0;
+	for (auto _ : state) {
+		uint64_t before = allocations;
+		BigInteger counter = 0;
+		for (int64_t i = 0; i < state.range(0); i++) {
+			++counter;
+		}
+		benchmark::DoNotOptimize(counter);
+		count += allocations - before;
+	}
+	report_allocations(state, count);
+}
+BENCHMARK(Increment)->Arg(1000);
+
+static void CounterLoop(benchmark::State& state) {
+	uint64_t count = 0;
+	BigInteger limit = state.range(0);
+	for (auto _ : state) {
+		uint64_t before = allocations;
+		BigInteger sum = 0;
+		for (BigInteger i = 0; i < limit; ++i) {
+			sum = sum + i * i;
+		}
+		benchmark::DoNotOptimize(sum);
+		count += allocations - before;
+	}
+	report_allocations(state, count);
+}
+BENCHMARK(CounterLoop)->Arg(1000);
+
+/* Values past the inline capacity spill to the heap */
+static void WideCounterLoop(benchmark::State& state) {
+	uint64_t count = 0;
+	BigInteger start = BigInteger(1) << 320;
+	BigInteger limit = start + state.range(0);
+	for (auto _ : state) {
+		uint64_t before = allocations;
+		BigInteger sum = 0;
+		for (BigInteger i = start; i < limit; ++i) {
+			sum = sum + i;
+		}
+		benchmark::DoNotOptimize(sum);
+		count += allocations - before;
+	}
+	report_allocations(state, count);
+}
+BENCHMARK(WideCounterLoop)->Arg(1000);
+
+/* A product added to an accumulator is fused into it without a temporary */
+static void MultiplyAccumulate(benchmark::State& state) {
+	uint64_t count = 0;
+	BigInteger first = (BigInteger(1) << (64 * state.range(0))) - 3;
+	BigInteger second = (BigInteger(1) << (64 * state.range(0))) - 5;
+	for (auto _ : state) {
+		BigInteger sum = BigInteger(1) << (64 * 2 * state.range(0) + 64);
+		uint64_t before = allocations;
+		for (int32_t i = 0; i < 100; i++) {
+			sum -= first * second;
+		}
+		count += allocations - before;
+		benchmark::DoNotOptimize(sum);
+	}
+	report_allocations(state, count);
+}
+BENCHMARK(MultiplyAccumulate)->Arg(8)->Arg(64);
+
+/* Temporaries of a whole computation come from one arena that is released at once */
+static void ArenaScope(benchmark::State& state) {
+	uint64_t count = 0;
+	BigInteger first = (BigInteger(1) << (64 * state.range(0))) - 3;
+	BigInteger second = (BigInteger(1) << (64 * state.range(0) / 2)) - 5;
+	LimbArena arena;
+	for (auto _ : state) {
+		uint64_t before = allocations;
+		{
+			LimbResource::Scope scope(arena);
+			BigInteger result = (first * first + second) / second % first;
+			benchmark::DoNotOptimize(result);
+		}
+		arena.release();
+		count += allocations - before;
+	}
+	report_allocations(state, count);
+}
+BENCHMARK(ArenaScope)->Arg(8)->Arg(64);
+
+static void HeapScope(benchmark::State& state) {
+	uint64_t count = 0;
+	BigInteger first = (BigInteger(1) << (64 * state.range(0))) - 3;
+	BigInteger second = (BigInteger(1) << (64 * state.range(0) / 2)) - 5;
+	for (auto _ : state) {
+		uint64_t before = allocations;
+		BigInteger result = (first * first + second) / second % first;
+		benchmark::DoNotOptimize(result);
+		count += allocations - before;
+	}
+	report_allocations(state, count);
+}
+BENCHMARK(HeapScope)->Arg(8)->Arg(64);
+
+/* Columns of 100000 numbers of the given number of limbs, added elementwise */
+static std::vector<BigInteger> column(int64_t limbs, int64_t seed) {
+	std::vector<BigInteger> numbers;
+	for (int64_t i = 0; i < 100000; i++) {
+		numbers.push_back((BigInteger(1) << (64 * limbs - 1)) - i * seed);
+	}
+	return numbers;
+}
+
+static void VectorAdd(benchmark::State& state) {
+	uint64_t count = 0;
+	std::vector<BigInteger> first = column(state.range(0), 3);
+	std::vector<BigInteger> second = column(state.range(0), -5);
+	for (auto _ : state) {
+		uint64_t before = allocations;
+		std::vector<BigInteger> sums;
+		sums.reserve(first.size());
+		for (uint64_t i = 0; i < first.size(); i++) {
+			sums.push_back(first[i] + second[i]);
+		}
+		benchmark::DoNotOptimize(sums);
+		count += allocations - before;
+	}
+	report_allocations(state, count);
+}
+BENCHMARK(VectorAdd)->Arg(2)->Arg(8)->Unit(benchmark::kMicrosecond);
+
+static void ArrayAdd(benchmark::State& state) {
+	uint64_t count = 0;
+	BigIntegerArray first(column(state.range(0), 3));
+	BigIntegerArray second(column(state.range(0), -5));
+	for (auto _ : state) {
+		uint64_t before = allocations;
+		BigIntegerArray sums = BigIntegerArray::add(first, second);
+		benchmark::DoNotOptimize(sums);
+		count += allocations - before;
+	}
+	report_allocations(state, count);
+}
+BENCHMARK(ArrayAdd)->Arg(2)->Arg(8)->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,42 @@
+#include <cstdint>
+
+#include <benchmark/benchmark.h>
+
+#include <BigInteger.hpp>
+#include <FixedInteger.hpp>
+
+/* a = a * b + c over 256 bit values, wrapping for the fixed width and reduced by a mask for BigInteger */
+static void MultiplyAddFixed(benchmark::State& state) {
+	UInt256 a = UInt256::max() / 3, b = UInt256::max() / 5, c = UInt256::max() / 7;
+	for (auto _ : state) {
+		a = a * b + c;
+		benchmark::DoNotOptimize(a);
+	}
+}
+BENCHMARK(MultiplyAddFixed);
+
+static void MultiplyAddBigInteger(benchmark::State& state) {
+	BigInteger mask = (BigInteger(1) << 256) - 1;
+	BigInteger a = mask / 3, b = mask / 5, c = mask / 7;
+	for (auto _ : state) {
+		a = (a * b + c) & mask;
+		benchmark::DoNotOptimize(a);
+	}
+}
+BENCHMARK(MultiplyAddBigInteger);
+
+static void DivideFixed(benchmark::State& state) {
+	UInt512 a = UInt512::max() / 3, b = UInt512::max() >> 200;
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(a / b);
+	}
+}
+BENCHMARK(DivideFixed);
+
+static void DivideBigInteger(benchmark::State& state) {
+	BigInteger a = static_cast<BigInteger>(UInt512::max() / 3), b = static_cast<BigInteger>(UInt512::max() >> 200);
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(a / b);
+	}
+}
+BENCHMARK(DivideBigInteger);
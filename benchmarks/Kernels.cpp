@@ -0,0 +1,118 @@
+#include <vector>
+#include <cstdint>
+
+#include <benchmark/benchmark.h>
+
+#include <LimbKernels.hpp>
+#include <Multiplication.hpp>
+
+using unit_type = LimbKernels::unit_type;
+
+static std::vector<unit_type> limbs(int64_t n, uint64_t seed) {
+	std::vector<unit_type> result(static_cast<uint64_t>(n));
+	for (unit_type& limb : result) {
+		seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+		limb = seed;
+	}
+	return result;
+}
+
+/* Runs kernel(r, a, b, n) on operands of state.range(0) limbs, r starts out as a copy of b */
+template<typename Kernel>
+static void run(benchmark::State& state, const Kernel& kernel) {
+	int64_t n = state.range(0);
+	std::vector<unit_type> a = limbs(n, 1), b = limbs(n, 2), r = b;
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(kernel(r.data(), a.data(), b.data(), static_cast<uint64_t>(n)));
+		benchmark::ClobberMemory();
+	}
+	state.SetItemsProcessed(state.iterations() * n);
+}
+
+static void AddPortable(benchmark::State& state) {
+	run(state, LimbKernels::add_n_portable);
+}
+BENCHMARK(AddPortable)->Arg(16)->Arg(256);
+
+static void Add(benchmark::State& state) {
+	run(state, LimbKernels::add_n);
+}
+BENCHMARK(Add)->Arg(16)->Arg(256);
+
+static void SubPortable(benchmark::State& state) {
+	run(state, LimbKernels::sub_n_portable);
+}
+BENCHMARK(SubPortable)->Arg(16)->Arg(256);
+
+static void Sub(benchmark::State& state) {
+	run(state, LimbKernels::sub_n);
+}
+BENCHMARK(Sub)->Arg(16)->Arg(256);
+
+static void MulLimbPortable(benchmark::State& state) {
+	run(state, [](unit_type* r, const unit_type* a, const unit_type* b, uint64_t n) {
+		return LimbKernels::mul_1_portable(r, a, n, b[0]);
+	});
+}
+BENCHMARK(MulLimbPortable)->Arg(16)->Arg(256);
+
+static void MulLimb(benchmark::State& state) {
+	run(state, [](unit_type* r, const unit_type* a, const unit_type* b, uint64_t n) {
+		return LimbKernels::mul_1(r, a, n, b[0]);
+	});
+}
+BENCHMARK(MulLimb)->Arg(16)->Arg(256);
+
+static void AddMulLimbPortable(benchmark::State& state) {
+	run(state, [](unit_type* r, const unit_type* a, const unit_type* b, uint64_t n) {
+		return LimbKernels::addmul_1_portable(r, a, n, b[0]);
+	});
+}
+BENCHMARK(AddMulLimbPortable)->Arg(16)->Arg(256);
+
+static void AddMulLimb(benchmark::State& state) {
+	run(state, [](unit_type* r, const unit_type* a, const unit_type* b, uint64_t n) {
+		return LimbKernels::addmul_1(r, a, n, b[0]);
+	});
+}
+BENCHMARK(AddMulLimb)->Arg(16)->Arg(256);
+
+static void SubMulLimbPortable(benchmark::State& state) {
+	run(state, [](unit_type* r, const unit_type* a, const unit_type* b, uint64_t n) {
+		return LimbKernels::submul_1_portable(r, a, n, b[0]);
+	});
+}
+BENCHMARK(SubMulLimbPortable)->Arg(16)->Arg(256);
+
+static void SubMulLimb(benchmark::State& state) {
+	run(state, [](unit_type* r, const unit_type* a, const unit_type* b, uint64_t n) {
+		return LimbKernels::submul_1(r, a, n, b[0]);
+	});
+}
+BENCHMARK(SubMulLimb)->Arg(16)->Arg(256);
+
+/* Schoolbook product on the portable loops, the baseline for the dispatched products below */
+static void ProductPortable(benchmark::State& state) {
+	int64_t n = state.range(0);
+	std::vector<unit_type> a = limbs(n, 1), b = limbs(n, 2), r(2 * a.size());
+	for (auto _ : state) {
+		r[a.size()] = LimbKernels::mul_1_portable(r.data(), a.data(), a.size(), b[0]);
+		for (uint64_t i = 1; i < b.size(); i++) {
+			r[a.size() + i] = LimbKernels::addmul_1_portable(r.data() + i, a.data(), a.size(), b[i]);
+		}
+		benchmark::DoNotOptimize(r.data());
+		benchmark::ClobberMemory();
+	}
+}
+BENCHMARK(ProductPortable)->Arg(8)->Arg(32)->Arg(64)->Arg(256);
+
+static void Product(benchmark::State& state) {
+	int64_t n = state.range(0);
+	std::vector<unit_type> a = limbs(n, 1), b = limbs(n, 2), r(2 * a.size());
+	for (auto _ : state) {
+		Multiplication::mul(r.data(), a.data(), a.size(), b.data(), b.size());
+		benchmark::DoNotOptimize(r.data());
+		benchmark::ClobberMemory();
+	}
+}
+BENCHMARK(Product)->Arg(8)->Arg(32)->Arg(64)->Arg(256);
@@ -0,0 +1,92 @@
+#include <cstdint>
+
+#include <benchmark/benchmark.h>
+
+#include <BigInteger.hpp>
+#include <ModContext.hpp>
+
+/* Deterministic operand of exactly the given number of bits */
+static BigInteger operand(int64_t bits, uint64_t seed) {
+	BigInteger result = 1;
+	for (int64_t i = 0; i < bits; i += 64) {
+		seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+		result = (result << 64) + seed;
+	}
+	return result >> (64 * ((bits + 63) / 64) - bits + 1);
+}
+
+/* The second argument is the low bit of the modulus, odd moduli use Montgomery and even ones Barrett */
+static BigInteger modulus(benchmark::State& state) {
+	return ((operand(state.range(0), 1) >> 1) << 1) + state.range(1);
+}
+
+static void PowmodContext(benchmark::State& state) {
+	BigInteger modulus = ::modulus(state);
+	BigInteger base = operand(state.range(0) - 1, 2);
+	BigInteger exponent = operand(state.range(0), 3);
+	ModContext context(modulus);
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(context.powmod(base, exponent));
+	}
+}
+BENCHMARK(PowmodContext)->Args({2048, 0})->Args({2048, 1})->Args({4096, 0})->Args({4096, 1})->Unit(benchmark::kMillisecond);
+
+/* Square and multiply with a full division after every step */
+static void PowmodDivision(benchmark::State& state) {
+	BigInteger modulus = ::modulus(state);
+	BigInteger base = operand(state.range(0) - 1, 2);
+	BigInteger exponent = operand(state.range(0), 3);
+	for (auto _ : state) {
+		BigInteger result = 1;
+		for (int64_t bit = state.range(0) - 1; bit >= 0; bit--) {
+			result = result * result % modulus;
+			if (((exponent >> bit) & 1) != 0) {
+				result = result * base % modulus;
+			}
+		}
+		benchmark::DoNotOptimize(result);
+	}
+}
+BENCHMARK(PowmodDivision)->Args({2048, 0})->Args({2048, 1})->Args({4096, 0})->Args({4096, 1})->Unit(benchmark::kMillisecond);
+
+static void Power(benchmark::State& state) {
+	BigInteger base = operand(state.range(0), 4);
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(BigInteger::pow(base, 1000));
+	}
+}
+BENCHMARK(Power)->Arg(64)->Arg(1024)->Unit(benchmark::kMillisecond);
+
+static void SquareRoot(benchmark::State& state) {
+	BigInteger number = operand(state.range(0), 5);
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(BigInteger::isqrt(number));
+	}
+}
+BENCHMARK(SquareRoot)->Arg(4096)->Arg(65536)->Unit(benchmark::kMillisecond);
+
+static void PerfectPower(benchmark::State& state) {
+	BigInteger number = operand(state.range(0), 6) | 1;
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(BigInteger::is_perfect_power(number));
+	}
+}
+BENCHMARK(PerfectPower)->Arg(4096)->Arg(65536)->Unit(benchmark::kMillisecond);
+
+static void Gcd(benchmark::State& state) {
+	BigInteger first = operand(state.range(0), 7);
+	BigInteger second = operand(state.range(0), 8);
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(BigInteger::gcd(first, second));
+	}
+}
+BENCHMARK(Gcd)->Arg(128)->Arg(1024)->Arg(16384)->Arg(262144)->Unit(benchmark::kMicrosecond);
+
+static void GcdExt(benchmark::State& state) {
+	BigInteger first = operand(state.range(0), 7);
+	BigInteger second = operand(state.range(0), 8);
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(BigInteger::gcdext(first, second));
+	}
+}
+BENCHMARK(GcdExt)->Arg(128)->Arg(16384)->Unit(benchmark::kMicrosecond);
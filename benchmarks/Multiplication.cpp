@@ -0,0 +1,49 @@
+#include <cstdint>
+#include <execution>
+
+#include <benchmark/benchmark.h>
+
+#include <BigInteger.hpp>
+#include <ThreadPool.hpp>
+
+/* Deterministic operand of the given number of limbs, built by halves to keep the setup fast for million limb numbers */
+static BigInteger operand(int64_t limbs, uint64_t seed) {
+	if (limbs == 1) {
+		return BigInteger(seed * 6364136223846793005ULL + 1442695040888963407ULL);
+	}
+
+	int64_t low = limbs / 2;
+	return (operand(limbs - low, seed * 3 + 1) << (64 * low)) + operand(low, seed * 3 + 2);
+}
+
+/* Balanced product of two numbers of the given number of limbs on the calling thread */
+static void Multiply(benchmark::State& state) {
+	BigInteger first = operand(state.range(0), 1);
+	BigInteger second = operand(state.range(0), 2);
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(BigInteger::multiply(first, second, std::execution::seq));
+	}
+}
+BENCHMARK(Multiply)->Arg(2048)->Arg(65536)->Arg(1048576)->Unit(benchmark::kMillisecond);
+
+/* The same product on a pool of the concurrency given by the second argument */
+static void MultiplyParallel(benchmark::State& state) {
+	BigInteger first = operand(state.range(0), 1);
+	BigInteger second = operand(state.range(0), 2);
+	ThreadPool pool(static_cast<uint64_t>(state.range(1)));
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(BigInteger::multiply(first, second, pool));
+	}
+}
+BENCHMARK(MultiplyParallel)->ArgsProduct({{2048, 65536, 1048576}, {2, 4, 8, 16}})->UseRealTime()->Unit(benchmark::kMillisecond);
+
+/* 2n by n limb division on a pool of the concurrency given by the second argument, 1 runs on the calling thread */
+static void DivideParallel(benchmark::State& state) {
+	BigInteger divisor = operand(state.range(0), 2);
+	BigInteger dividend = BigInteger::multiply(operand(state.range(0), 1), divisor, std::execution::seq) + 1;
+	ThreadPool pool(static_cast<uint64_t>(state.range(1)));
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(BigInteger::divmod(dividend, divisor, pool));
+	}
+}
+BENCHMARK(DivideParallel)->ArgsProduct({{8192, 65536}, {1, 2, 4, 8}})->UseRealTime()->Unit(benchmark::kMillisecond);
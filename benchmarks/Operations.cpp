@@ -0,0 +1,293 @@
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <utility>
+#include <algorithm>
+
+#include <benchmark/benchmark.h>
+
+#include <BigInteger.hpp>
+#include <BigAccumulator.hpp>
+
+/*
+ * Every public operation over operands of 1 to 2^20 limbs. The quadratic parts of the library, and the operations whose
+ * results grow with the operands, stop earlier so a full run stays within a few minutes. The second argument of the
+ * binary operations is the ratio of the operand sizes, 1 for balanced operands.
+ */
+
+/* Deterministic operand of the given number of limbs, built by halves to keep the setup fast for million limb numbers */
+static BigInteger operand(int64_t limbs, uint64_t seed) {
+	if (limbs == 1) {
+		return BigInteger(seed * 6364136223846793005ULL + 1442695040888963407ULL);
+	}
+
+	int64_t low = limbs / 2;
+	return (operand(limbs - low, seed * 3 + 1) << (64 * low)) + operand(low, seed * 3 + 2);
+}
+
+/* Operands of state.range(0) limbs and of that divided by state.range(1) */
+static std::pair<BigInteger, BigInteger> operands(const benchmark::State& state) {
+	int64_t n = state.range(0);
+	return {operand(n, 1), operand(std::max<int64_t>(n / state.range(1), 1), 2)};
+}
+
+static void sizes(benchmark::internal::Benchmark* benchmark, int64_t largest) {
+	benchmark->RangeMultiplier(8)->Range(1, largest)->Unit(benchmark::kMicrosecond);
+}
+
+static void shapes(benchmark::internal::Benchmark* benchmark, int64_t largest) {
+	std::vector<int64_t> limbs;
+	for (int64_t n = 1; n < largest; n *= 8) {
+		limbs.push_back(n);
+	}
+	limbs.push_back(largest);
+	benchmark->ArgsProduct({limbs, {1, 16}})->Unit(benchmark::kMicrosecond);
+}
+
+static void IntegerParse(benchmark::State& state) {
+	std::string digits = operand(state.range(0), 1).to_string();
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(BigInteger(digits));
+	}
+}
+BENCHMARK(IntegerParse)->Apply([](auto* benchmark) { sizes(benchmark, 1 << 15); });
+
+static void IntegerPrint(benchmark::State& state) {
+	BigInteger number = operand(state.range(0), 1);
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(number.to_string());
+	}
+}
+BENCHMARK(IntegerPrint)->Apply([](auto* benchmark) { sizes(benchmark, 1 << 15); });
+
+static void IntegerAdd(benchmark::State& state) {
+	auto [first, second] = operands(state);
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(first + second);
+	}
+}
+BENCHMARK(IntegerAdd)->Apply([](auto* benchmark) { shapes(benchmark, 1 << 20); });
+
+static void IntegerSubtract(benchmark::State& state) {
+	auto [first, second] = operands(state);
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(first - second);
+	}
+}
+BENCHMARK(IntegerSubtract)->Apply([](auto* benchmark) { shapes(benchmark, 1 << 20); });
+
+/* Products of lvalues are lazy, the conversion does the multiplication */
+static void IntegerProduct(benchmark::State& state) {
+	auto [first, second] = operands(state);
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(BigInteger(first * second));
+	}
+}
+BENCHMARK(IntegerProduct)->Apply([](auto* benchmark) { shapes(benchmark, 1 << 20); });
+
+/* The dividend is the product of the operands, so ratio 1 is the balanced 2n by n division */
+static void IntegerDivide(benchmark::State& state) {
+	auto [first, second] = operands(state);
+	BigInteger dividend = first * second + 1;
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(dividend / second);
+	}
+}
+BENCHMARK(IntegerDivide)->Apply([](auto* benchmark) { shapes(benchmark, 1 << 18); });
+
+static void IntegerRemainder(benchmark::State& state) {
+	auto [first, second] = operands(state);
+	BigInteger dividend = first * second + 1;
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(dividend % second);
+	}
+}
+BENCHMARK(IntegerRemainder)->Apply([](auto* benchmark) { shapes(benchmark, 1 << 18); });
+
+static void IntegerPower(benchmark::State& state) {
+	BigInteger base = operand(state.range(0), 1);
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(BigInteger::pow(base, 8));
+	}
+}
+BENCHMARK(IntegerPower)->Apply([](auto* benchmark) { sizes(benchmark, 1 << 15); });
+
+static void IntegerShiftLeft(benchmark::State& state) {
+	BigInteger number = operand(state.range(0), 1);
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(number << 100);
+	}
+}
+BENCHMARK(IntegerShiftLeft)->Apply([](auto* benchmark) { sizes(benchmark, 1 << 20); });
+
+static void IntegerShiftRight(benchmark::State& state) {
+	BigInteger number = operand(state.range(0), 1);
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(number >> 100);
+	}
+}
+BENCHMARK(IntegerShiftRight)->Apply([](auto* benchmark) { sizes(benchmark, 1 << 20); });
+
+/* A negative second operand takes the two's complement paths */
+static void IntegerAnd(benchmark::State& state) {
+	auto [first, second] = operands(state);
+	second = -second;
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(first & second);
+	}
+}
+BENCHMARK(IntegerAnd)->Apply([](auto* benchmark) { shapes(benchmark, 1 << 20); });
+
+static void IntegerOr(benchmark::State& state) {
+	auto [first, second] = operands(state);
+	second = -second;
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(first | second);
+	}
+}
+BENCHMARK(IntegerOr)->Apply([](auto* benchmark) { shapes(benchmark, 1 << 20); });
+
+static void IntegerXor(benchmark::State& state) {
+	auto [first, second] = operands(state);
+	second = -second;
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(first ^ second);
+	}
+}
+BENCHMARK(IntegerXor)->Apply([](auto* benchmark) { shapes(benchmark, 1 << 20); });
+
+/* Operands equal up to the lowest limb, the longest comparison */
+static void IntegerCompare(benchmark::State& state) {
+	BigInteger first = operand(state.range(0), 1);
+	BigInteger second = first + 1;
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(first < second);
+	}
+}
+BENCHMARK(IntegerCompare)->Apply([](auto* benchmark) { sizes(benchmark, 1 << 20); });
+
+static void IntegerDecimalToBinary(benchmark::State& state) {
+	BigInteger number = -operand(state.range(0), 1);
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(BigInteger::dec2bin(number));
+	}
+}
+BENCHMARK(IntegerDecimalToBinary)->Apply([](auto* benchmark) { sizes(benchmark, 1 << 20); });
+
+static void IntegerBinaryToDecimal(benchmark::State& state) {
+	std::vector<BigInteger::unit_type> binary = BigInteger::dec2bin(operand(state.range(0), 1));
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(BigInteger::bin2dec(binary));
+	}
+}
+BENCHMARK(IntegerBinaryToDecimal)->Apply([](auto* benchmark) { sizes(benchmark, 1 << 20); });
+
+/* Built in integer operands, which run the single limb kernels without converting them first */
+static void IntegerIncrement(benchmark::State& state) {
+	BigInteger number = operand(state.range(0), 1);
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(++number);
+	}
+}
+BENCHMARK(IntegerIncrement)->Apply([](auto* benchmark) { sizes(benchmark, 1 << 20); });
+
+static void IntegerMultiplyScalar(benchmark::State& state) {
+	BigInteger number = operand(state.range(0), 1);
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(number * 1000000007);
+	}
+}
+BENCHMARK(IntegerMultiplyScalar)->Apply([](auto* benchmark) { sizes(benchmark, 1 << 20); });
+
+static void IntegerDivideScalar(benchmark::State& state) {
+	BigInteger number = operand(state.range(0), 1);
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(number / 1000000007);
+	}
+}
+BENCHMARK(IntegerDivideScalar)->Apply([](auto* benchmark) { sizes(benchmark, 1 << 20); });
+
+static void IntegerPopcount(benchmark::State& state) {
+	BigInteger number = operand(state.range(0), 1);
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(number.popcount());
+	}
+}
+BENCHMARK(IntegerPopcount)->Apply([](auto* benchmark) { sizes(benchmark, 1 << 20); });
+
+/* A 64 bit field straddling two limbs of a negative number */
+static void IntegerExtractBits(benchmark::State& state) {
+	BigInteger number = -operand(state.range(0), 1);
+	uint64_t low = static_cast<uint64_t>(state.range(0)) * 32 + 7;
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(number.extract_bits(low, low + 64));
+	}
+}
+BENCHMARK(IntegerExtractBits)->Apply([](auto* benchmark) { sizes(benchmark, 1 << 20); });
+
+/* Sums of 2^16 numbers of the given size with alternating signs, by repeated += and by BigAccumulator */
+static std::vector<BigInteger> terms(int64_t limbs) {
+	std::vector<BigInteger> numbers;
+	for (uint64_t i = 0; i < 1 << 16; i++) {
+		BigInteger number = operand(limbs, i + 1);
+		numbers.push_back(i % 3 == 0 ? -number : number);
+	}
+	return numbers;
+}
+
+static void IntegerSumRepeated(benchmark::State& state) {
+	std::vector<BigInteger> numbers = terms(state.range(0));
+	for (auto _ : state) {
+		BigInteger sum;
+		for (const BigInteger& number : numbers) {
+			sum += number;
+		}
+		benchmark::DoNotOptimize(sum);
+	}
+}
+BENCHMARK(IntegerSumRepeated)->RangeMultiplier(8)->Range(1, 512)->Unit(benchmark::kMicrosecond);
+
+static void IntegerSumAccumulator(benchmark::State& state) {
+	std::vector<BigInteger> numbers = terms(state.range(0));
+	for (auto _ : state) {
+		BigAccumulator accumulator;
+		for (const BigInteger& number : numbers) {
+			accumulator.add(number);
+		}
+		benchmark::DoNotOptimize(accumulator.result());
+	}
+}
+BENCHMARK(IntegerSumAccumulator)->RangeMultiplier(8)->Range(1, 512)->Unit(benchmark::kMicrosecond);
+
+static void IntegerSumParallel(benchmark::State& state) {
+	std::vector<BigInteger> numbers = terms(state.range(0));
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(BigAccumulator::sum(numbers, std::execution::par));
+	}
+}
+BENCHMARK(IntegerSumParallel)->RangeMultiplier(8)->Range(1, 512)->Unit(benchmark::kMicrosecond)->UseRealTime();
+
+/* Dot products of 2^16 pairs, by the fused sum += a * b and by BigAccumulator::add_product */
+static void IntegerDotRepeated(benchmark::State& state) {
+	std::vector<BigInteger> numbers = terms(state.range(0));
+	for (auto _ : state) {
+		BigInteger sum;
+		for (uint64_t i = 1; i < numbers.size(); i++) {
+			sum += numbers[i - 1] * numbers[i];
+		}
+		benchmark::DoNotOptimize(sum);
+	}
+}
+BENCHMARK(IntegerDotRepeated)->RangeMultiplier(8)->Range(1, 64)->Unit(benchmark::kMicrosecond);
+
+static void IntegerDotAccumulator(benchmark::State& state) {
+	std::vector<BigInteger> numbers = terms(state.range(0));
+	for (auto _ : state) {
+		BigAccumulator accumulator;
+		for (uint64_t i = 1; i < numbers.size(); i++) {
+			accumulator.add_product(numbers[i - 1], numbers[i]);
+		}
+		benchmark::DoNotOptimize(accumulator.result());
+	}
+}
+BENCHMARK(IntegerDotAccumulator)->RangeMultiplier(8)->Range(1, 64)->Unit(benchmark::kMicrosecond);
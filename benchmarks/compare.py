@@ -0,0 +1,90 @@
+#!/usr/bin/env python3
+"""
+Compares two JSON outputs of the bench target and flags the benchmarks that got slower.
+
+    bench --benchmark_out=new.json --benchmark_out_format=json
+    benchmarks/compare.py baseline.json new.json
+
+With --benchmark_repetitions the medians are compared, otherwise the single runs. The exit status is 1 when a benchmark
+is slower than the baseline by more than the threshold, so the script can gate a change.
+"""
+
+import argparse
+import json
+import re
+import sys
+
+UNITS = {"ns": 1.0, "us": 1e3, "ms": 1e6, "s": 1e9}
+
+
+def load(path, metric):
+    """Time in nanoseconds of every benchmark in the file, by name"""
+    with open(path) as file:
+        benchmarks = json.load(file)["benchmarks"]
+
+    times = {}
+    medians = {}
+    for benchmark in benchmarks:
+        if "error_occurred" in benchmark and benchmark["error_occurred"]:
+            continue
+        time = benchmark[metric] * UNITS[benchmark.get("time_unit", "ns")]
+        name = benchmark.get("run_name", benchmark["name"])
+        if benchmark.get("run_type") == "aggregate":
+            if benchmark.get("aggregate_name") == "median":
+                medians[name] = time
+        elif name not in times:
+            times[name] = time
+    times.update(medians)
+    return times
+
+
+def format_time(nanoseconds):
+    for unit in ("s", "ms", "us"):
+        if nanoseconds >= UNITS[unit]:
+            return f"{nanoseconds / UNITS[unit]:.3f} {unit}"
+    return f"{nanoseconds:.1f} ns"
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("baseline", help="results of the reference run")
+    parser.add_argument("current", help="results of the run to check")
+    parser.add_argument("--threshold", type=float, default=0.10, help="relative slowdown reported, 0.10 by default")
+    parser.add_argument("--metric", choices=("cpu_time", "real_time"), default="cpu_time")
+    parser.add_argument("--filter", default="", help="only the benchmarks whose name matches this regular expression")
+    arguments = parser.parse_args()
+
+    baseline = load(arguments.baseline, arguments.metric)
+    current = load(arguments.current, arguments.metric)
+    pattern = re.compile(arguments.filter)
+    names = [name for name in current if name in baseline and pattern.search(name)]
+    if not names:
+        print("No benchmark is in both runs.")
+        return 1
+
+    width = max(len(name) for name in names)
+    print(f"{'Benchmark':<{width}}  {'Baseline':>12}  {'Current':>12}  {'Change':>8}")
+    regressions = []
+    for name in names:
+        change = current[name] / baseline[name] - 1 if baseline[name] > 0 else 0.0
+        flag = ""
+        if change > arguments.threshold:
+            flag = "  SLOWER"
+            regressions.append(name)
+        elif change < -arguments.threshold:
+            flag = "  faster"
+        print(f"{name:<{width}}  {format_time(baseline[name]):>12}  {format_time(current[name]):>12}  {change:>+8.1%}{flag}")
+
+    missing = [name for name in baseline if name not in current and pattern.search(name)]
+    if missing:
+        print(f"\nNot in the current run: {', '.join(missing)}")
+
+    if regressions:
+        print(f"\n{len(regressions)} of {len(names)} benchmarks are more than {arguments.threshold:.0%} slower.")
+        return 1
+    print(f"\nNo benchmark is more than {arguments.threshold:.0%} slower.")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
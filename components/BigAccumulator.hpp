@@ -0,0 +1,202 @@
+#pragma once
+
+#include <span>
+#include <cstdint>
+#include <utility>
+#include <algorithm>
+#include <execution>
+#include <type_traits>
+
+#include <BigInteger.hpp>
+#include <BigIntegerView.hpp>
+#include <LimbKernels.hpp>
+#include <LimbAllocator.hpp>
+#include <Multiplication.hpp>
+#include <ThreadPool.hpp>
+#include <Traits.hpp>
+
+/*
+ * Running sum of many numbers in a redundant form. The positive and the negative terms go to separate parts, each a
+ * limb buffer plus a count of the carries still owed to every limb. A term is added over its own width only and its
+ * carry out is counted instead of being carried through the limbs above, so an add never resizes, normalizes or
+ * checks signs. The counts are settled once, by result().
+ */
+class BigAccumulator {
+public:
+	using unit_type = LimbKernels::unit_type;
+
+private:
+
+	/* Numbers summed by one task of the parallel reduction */
+	static constexpr uint64_t parallel_grain = 4096;
+
+	/* sums + sum of carries[i] * 2^(64 i), carries has one more entry than sums for the carries out of the top limb */
+	struct Part {
+		limb_vector sums;
+		limb_vector carries = limb_vector(1);
+
+		constexpr void reserve(uint64_t n) {
+			if (sums.size() < n) {
+				sums.resize(n);
+				carries.resize(n + 1);
+			}
+		}
+
+		/* Adds the n limbs to the limbs from offset on, which must all exist */
+		constexpr void add(const unit_type* a, uint64_t n, uint64_t offset) {
+			unit_type* s = sums.data() + offset;
+			if (n == 1) {
+				this->add_limb(a[0], offset);
+				return;
+			}
+			carries[offset + n] += LimbKernels::add_n(s, s, a, n);
+		}
+
+		constexpr void add_limb(unit_type limb, uint64_t offset) {
+			sums[offset] += limb;
+			carries[offset + 1] += sums[offset] < limb;
+		}
+
+		constexpr void merge(const Part& other) {
+			uint64_t n = other.sums.size();
+			this->reserve(n);
+			this->add(other.sums.data(), n, 0);
+			for (uint64_t i = 0; i <= n; i++) {
+				carries[i] += other.carries[i];
+			}
+		}
+
+		/* The value with every carry settled, normalized */
+		[[nodiscard]] constexpr limb_vector settle() const {
+			uint64_t n = sums.size();
+			limb_vector value(n + 2);
+			LimbKernels::copy(value.data(), sums.data(), n);
+			value[n + 1] = LimbKernels::add_n(value.data(), value.data(), carries.data(), n + 1);
+			value.resize(LimbKernels::normalized_size(value.data(), n + 2));
+			return value;
+		}
+	};
+
+	Part positive_;
+	Part negative_;
+	limb_vector product_;
+
+	constexpr Part& part_of(bool negative) {
+		return negative ? negative_ : positive_;
+	}
+
+	/* Splits the numbers in halves over the pool, each half into an accumulator of its own merged afterwards */
+	void add_all(std::span<const BigInteger> numbers, ThreadPool* pool) {
+		if (pool == nullptr || numbers.size() <= parallel_grain) {
+			for (const BigInteger& number : numbers) {
+				this->add(number);
+			}
+			return;
+		}
+
+		uint64_t middle = numbers.size() / 2;
+		BigAccumulator high;
+		pool->invoke([&] { this->add_all(numbers.first(middle), pool); },
+					 [&] { high.add_all(numbers.subspan(middle), pool); });
+		this->merge(high);
+	}
+
+public:
+
+	constexpr BigAccumulator() = default;
+
+	constexpr void add(const BigInteger& number) {
+		BigIntegerView view = number.view();
+		Part& part = this->part_of(view.is_negative());
+		part.reserve(view.size());
+		part.add(view.data(), view.size(), 0);
+	}
+
+	template<Integer T>
+	constexpr void add(T value) {
+		if constexpr (sizeof(T) > sizeof(unit_type)) {
+			this->add(BigInteger(value));
+		} else {
+			auto magnitude = static_cast<unit_type>(value);
+			bool negative = false;
+			if constexpr (std::is_signed_v<T>) {
+				negative = value < 0;
+				magnitude = negative ? 0 - magnitude : magnitude;
+			}
+
+			Part& part = this->part_of(negative);
+			part.reserve(1);
+			part.add_limb(magnitude, 0);
+		}
+	}
+
+	/*
+	 * Adds first * second. Below the Karatsuba threshold every row of the schoolbook product is multiplied straight into
+	 * the sums and only its top limb is deferred, larger products go through a buffer kept for the next call.
+	 */
+	constexpr void add_product(const BigInteger& first, const BigInteger& second) {
+		BigIntegerView a = first.view();
+		BigIntegerView b = second.view();
+		if (!a || !b) {
+			return;
+		}
+
+		if (a.size() < b.size()) {
+			std::swap(a, b);
+		}
+		uint64_t an = a.size();
+		uint64_t bn = b.size();
+		Part& part = this->part_of(a.is_negative() != b.is_negative());
+		part.reserve(an + bn);
+
+		if (bn < Multiplication::karatsuba_threshold) {
+			for (uint64_t i = 0; i < bn; i++) {
+				part.add_limb(LimbKernels::addmul_1(part.sums.data() + i, a.data(), an, b.data()[i]), i + an);
+			}
+			return;
+		}
+
+		product_.resize(an + bn);
+		Multiplication::mul(product_.data(), a.data(), an, b.data(), bn);
+		part.add(product_.data(), an + bn, 0);
+	}
+
+	/* Adds the terms of another accumulator, such as one filled on another thread */
+	constexpr void merge(const BigAccumulator& other) {
+		positive_.merge(other.positive_);
+		negative_.merge(other.negative_);
+	}
+
+	/* Adds every number, the parallel policies and a ThreadPool split them over threads */
+	template<typename Execution = const std::execution::sequenced_policy&>
+	void add(std::span<const BigInteger> numbers, Execution&& execution = std::execution::seq) {
+		this->add_all(numbers, ThreadPool::executor(execution));
+	}
+
+	template<typename Execution = const std::execution::sequenced_policy&>
+	[[nodiscard]] static BigInteger sum(std::span<const BigInteger> numbers, Execution&& execution = std::execution::seq) {
+		BigAccumulator accumulator;
+		accumulator.add(numbers, std::forward<Execution>(execution));
+		return accumulator.result();
+	}
+
+	/* Settles the carries and takes the negative terms off the positive ones, the accumulator keeps its terms */
+	[[nodiscard]] constexpr BigInteger result() const {
+		limb_vector positive = positive_.settle();
+		limb_vector negative = negative_.settle();
+		uint64_t pn = positive.size();
+		uint64_t nn = negative.size();
+
+		if (LimbKernels::compare(positive.data(), pn, negative.data(), nn) >= 0) {
+			LimbKernels::sub(positive.data(), positive.data(), pn, negative.data(), nn);
+			return BigInteger(BigIntegerView({positive.data(), pn}, false));
+		}
+		LimbKernels::sub(negative.data(), negative.data(), nn, positive.data(), pn);
+		return BigInteger(BigIntegerView({negative.data(), nn}, true));
+	}
+
+	constexpr void clear() {
+		positive_ = Part();
+		negative_ = Part();
+	}
+};
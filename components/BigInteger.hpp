@@ -1,488 +1,2071 @@
 #pragma once
 
-#include <regex>
+#include <bit>
+#include <array>
+#include <bitset>
+#include <utility>
+#include <tuple>
 #include <string>
 #include <limits>
+#include <istream>
 #include <climits>
 #include <compare>
+#include <execution>
 #include <algorithm>
 #include <type_traits>
 
 #include <NumberFormatException.hpp>
 #include <ArithmeticException.hpp>
 #include <BigNumber.hpp>
+#include <BigIntegerReader.hpp>
+#include <BigIntegerView.hpp>
+#include <Instrumentation.hpp>
+#include <LimbKernels.hpp>
+#include <LimbStorage.hpp>
+#include <LimbArena.hpp>
+#include <LimbPool.hpp>
+#include <Multiplication.hpp>
+#include <Division.hpp>
+#include <GreatestCommonDivisor.hpp>
+#include <NumberTheoreticTransform.hpp>
+#include <Serialization.hpp>
+#include <ThreadPool.hpp>
 #include <Traits.hpp>
 
 class BigInteger : public BigNumber {
+	friend class ModContext;
+	friend class BigIntegerArray;
 
 #define DECLARE_ASSIGNMENT_OPERATOR(op)									\
 	constexpr BigInteger& operator op##=(const BigInteger& other) {		\
 		(*this) = (*this) op other;										\
 		return *this;													\
 	}
+
+#define DECLARE_BINARY_OPERATOR(op)										\
+	constexpr BigInteger operator op(const BigInteger& other) const & {	\
+		BigInteger result(*this, std::max(this->integer_storage().size(), \
+										  other.integer_storage().size()) + 1); \
+		result op##= other;												\
+		return result;													\
+	}																	\
+	constexpr BigInteger operator op(const BigInteger& other) && {		\
+		(*this) op##= other;											\
+		return std::move(*this);										\
+	}
+
+#define DECLARE_COMMUTATIVE_OPERATOR(op)									\
+	DECLARE_BINARY_OPERATOR(op)											\
+	constexpr BigInteger operator op(BigInteger&& other) const & {		\
+		other op##= *this;												\
+		return std::move(other);										\
+	}																	\
+	constexpr BigInteger operator op(BigInteger&& other) && {			\
+		(*this) op##= other;											\
+		return std::move(*this);										\
+	}
+
+#define DECLARE_EVALUATING_OPERATOR(op)									\
+	friend constexpr BigInteger operator op(const Sum& first, const BigInteger& second) { \
+		return BigInteger(first) op second;								\
+	}																	\
+	friend constexpr BigInteger operator op(const BigInteger& first, const Sum& second) { \
+		return first op BigInteger(second);								\
+	}																	\
+	template<uint64_t M>												\
+	friend constexpr BigInteger operator op(const Sum& first, const Sum<M>& second) { \
+		return BigInteger(first) op BigInteger(second);					\
+	}
 	
-    void check_number(const std::string& number) const override {
-		std::regex integer_regex("-?\\d+");
-		if (!std::regex_match(number, integer_regex)) {
+    static void check_number(const std::string& number) {
+		uint64_t start = !number.empty() && number.front() == '-';
+		bool digits_only = std::all_of(number.begin() + static_cast<int64_t>(start), number.end(), [](char digit) {
+			return digit >= '0' && digit <= '9';
+		});
+		if (start == number.size() || !digits_only) {
 			throw NumberFormatException(number);
 		}
 	}
 	
-	static constexpr BigInteger divide_by_2(const BigInteger& number) {
-		BigInteger result = number;
-		uint8_t prev_carry = 0;
-		uint8_t next_carry;
-		
-		for (auto & unit : result.integer_storage()) {
-            next_carry = unit % 2;
-            unit = (unit / 2) + (prev_carry * half_overflow_unit_of_storage);
-			prev_carry = next_carry;
+	/* Copy of number with room for capacity limbs */
+	constexpr BigInteger(const BigInteger& number, uint64_t capacity) : BigNumber() {
+		this->integer_storage().reserve(capacity);
+		*this = number;
+	}
+
+	/* Adds other, or subtracts it when negate is set, in the limbs of this number */
+	constexpr void add_in_place(const BigInteger& other, bool negate) {
+		if (this == &other) {
+			if (negate) {
+				this->integer_storage().clear();
+			} else {
+				this->shift_left(1);
+			}
+			this->normalize();
+			return;
 		}
-		
-		if (result.integer_storage().size() >= 2 && result.integer_storage().front() == 0) {
-			result.integer_storage().erase(result.integer_storage().begin());
+
+		this->add_in_place(other.view(), negate);
+	}
+
+	/* The view must not point into the limbs of this number */
+	constexpr void add_in_place(BigIntegerView other, bool negate) {
+		auto& limbs = this->integer_storage();
+		const unit_type* other_limbs = other.data();
+		uint64_t an = limbs.size();
+		uint64_t bn = other.size();
+		bool other_negative = other.is_negative() != negate;
+		BIGNUMBER_INSTRUMENT(add, std::max(an, bn));
+
+		if ((this->state().is_negative != 0) == other_negative) {
+			limbs.resize(std::max(an, bn) + 1);
+			unit_type* r = limbs.data();
+			if (an >= bn) {
+				r[an] = LimbKernels::add(r, r, an, other_limbs, bn);
+			} else {
+				r[bn] = LimbKernels::add(r, other_limbs, bn, r, an);
+			}
+		} else if (LimbKernels::compare(std::as_const(limbs).data(), an, other_limbs, bn) >= 0) {
+			LimbKernels::sub(limbs.data(), limbs.data(), an, other_limbs, bn);
+		} else {
+			limbs.resize(bn);
+			LimbKernels::sub(limbs.data(), other_limbs, bn, limbs.data(), an);
+			this->state().is_negative = other_negative;
 		}
-		
+
+		this->normalize();
+	}
+
+	/* Quotient truncated towards zero and remainder with the sign of the dividend, the recursive division may use a pool */
+	static constexpr std::pair<BigInteger, BigInteger> divide(BigIntegerView dividend, BigIntegerView divisor, ThreadPool* pool) {
+		if (!divisor) {
+			throw ArithmeticException("Division by 0 is not allowed.");
+		}
+
+		BIGNUMBER_INSTRUMENT(divide, dividend.size());
+		if (LimbKernels::compare(dividend.data(), dividend.size(), divisor.data(), divisor.size()) < 0) {
+			return {BigInteger(), BigInteger(dividend)};
+		}
+
+		BigInteger quotient, remainder;
+		std::span<const unit_type> numerator = dividend.limbs();
+		std::span<const unit_type> denominator = divisor.limbs();
+		uint64_t nn = numerator.size();
+		uint64_t dn = denominator.size();
+
+		if (dn == 1) {
+			quotient.integer_storage().resize(nn);
+			unit_type rest = LimbKernels::divrem_1(quotient.integer_storage().data(), numerator.data(), nn, denominator[0]);
+			if (rest != 0) {
+				remainder.integer_storage().push_back(rest);
+			}
+		} else {
+			uint64_t shift = static_cast<uint64_t>(std::countl_zero(denominator.back()));
+			storage_type normalized_denominator;
+			normalized_denominator.assign(denominator.begin(), denominator.end());
+			storage_type& normalized_numerator = remainder.integer_storage();
+
+			normalized_numerator.assign(numerator.begin(), numerator.end());
+			normalized_numerator.push_back(0);
+			if (shift != 0) {
+				LimbKernels::lshift(normalized_denominator.data(), denominator.data(), dn, shift);
+				normalized_numerator.back() = LimbKernels::lshift(normalized_numerator.data(), numerator.data(), nn, shift);
+			}
+
+			quotient.integer_storage().resize(nn + 1 - dn);
+			Division::divrem(quotient.integer_storage().data(), normalized_numerator.data(), nn + 1,
+							 normalized_denominator.data(), dn, pool);
+
+			normalized_numerator.resize(dn);
+			if (shift != 0) {
+				LimbKernels::rshift(normalized_numerator.data(), normalized_numerator.data(), dn, shift);
+			}
+		}
+
+		quotient.state().is_negative = dividend.is_negative() != divisor.is_negative();
+		remainder.state().is_negative = dividend.is_negative();
+		quotient.normalize();
+		remainder.normalize();
+		return {std::move(quotient), std::move(remainder)};
+	}
+
+	/* Magnitude and sign of a built in integer in limbs of its own, an operand that needs no allocation */
+	template<Integer T>
+	struct Scalar {
+		static constexpr uint64_t size = (sizeof(T) + sizeof(unit_type) - 1) / sizeof(unit_type);
+
+		std::array<unit_type, size> limbs{};
+		bool negative = false;
+
+		constexpr explicit Scalar(T value) {
+			using unsigned_type = unsigned_integer_t<T>;
+			auto magnitude = static_cast<unsigned_type>(value);
+
+			if constexpr (std::is_signed_v<T>) {
+				if (value < 0) {
+					negative = true;
+					magnitude = static_cast<unsigned_type>(0 - magnitude);
+				}
+			}
+
+			for (unit_type& limb : limbs) {
+				limb = static_cast<unit_type>(magnitude);
+				if constexpr (sizeof(unsigned_type) > sizeof(unit_type)) {
+					magnitude >>= LimbKernels::unit_bits;
+				}
+			}
+		}
+
+		/* Whether the magnitude fits the lowest limb, always true for the types of at most 64 bits */
+		[[nodiscard]] constexpr bool is_limb() const {
+			return std::all_of(limbs.begin() + 1, limbs.end(), [](unit_type limb) { return limb == 0; });
+		}
+
+		[[nodiscard]] constexpr BigIntegerView view() const {
+			return {limbs, negative};
+		}
+	};
+
+	/* Adds the limb, negated when negative is set, in the limbs of this number, stopping where the carry or borrow ends */
+	constexpr void add_limb(unit_type limb, bool negative) {
+		auto& limbs = this->integer_storage();
+		uint64_t n = limbs.size();
+		BIGNUMBER_INSTRUMENT(add, n);
+
+		if (limb == 0) {
+			return;
+		}
+
+		if (n == 0) {
+			limbs.push_back(limb);
+			this->state().is_negative = negative;
+		} else if ((this->state().is_negative != 0) == negative) {
+			if (LimbKernels::increment(limbs.data(), n, limb) != 0) {
+				limbs.push_back(1);
+			}
+		} else if (n > 1 || std::as_const(limbs).front() >= limb) {
+			LimbKernels::decrement(limbs.data(), n, limb);
+			this->normalize();
+		} else {
+			limbs.front() = limb - limbs.front();
+			this->state().is_negative = negative;
+		}
+	}
+
+	/* Multiplies by the limb, negated when negative is set */
+	constexpr void multiply_limb(unit_type limb, bool negative) {
+		auto& limbs = this->integer_storage();
+		BIGNUMBER_INSTRUMENT(multiply, limbs.size());
+		unit_type* r = limbs.data();
+		unit_type carry = LimbKernels::mul_1(r, r, limbs.size(), limb);
+		if (carry != 0) {
+			limbs.push_back(carry);
+		}
+		this->state().is_negative = this->state().is_negative != negative;
+		this->normalize();
+	}
+
+	/* quotient = dividend / limb truncated towards zero, negated when negative is set, quotient may be the dividend */
+	static constexpr void divide_limb(BigInteger& quotient, const BigInteger& dividend, unit_type limb, bool negative) {
+		if (limb == 0) {
+			throw ArithmeticException("Division by 0 is not allowed.");
+		}
+
+		uint64_t n = dividend.integer_storage().size();
+		BIGNUMBER_INSTRUMENT(divide, n);
+		quotient.integer_storage().resize(n);
+		unit_type* q = quotient.integer_storage().data();
+		LimbKernels::divrem_1(q, dividend.integer_storage().data(), n, limb);
+		quotient.state().is_negative = dividend.state().is_negative != negative;
+		quotient.normalize();
+	}
+
+	/* Remainder of the magnitude divided by the limb */
+	[[nodiscard]] constexpr unit_type remainder_limb(unit_type limb) const {
+		if (limb == 0) {
+			throw ArithmeticException("Division by 0 is not allowed.");
+		}
+
+		BIGNUMBER_INSTRUMENT(divide, this->integer_storage().size());
+		return LimbKernels::mod_1(this->integer_storage().data(), this->integer_storage().size(), limb);
+	}
+
+	/* Multiplies the magnitude by 2^count */
+	constexpr void shift_left(uint64_t count) {
+		auto& limbs = this->integer_storage();
+		uint64_t n = limbs.size();
+		uint64_t units = count / LimbKernels::unit_bits;
+		uint64_t bits = count % LimbKernels::unit_bits;
+		BIGNUMBER_INSTRUMENT(shift, n);
+
+		if (n == 0 || count == 0) {
+			return;
+		}
+
+		limbs.resize(n + units + 1);
+		unit_type* r = limbs.data();
+		if (bits != 0) {
+			r[n + units] = LimbKernels::lshift(r + units, r, n, bits);
+		} else {
+			for (uint64_t i = n; i > 0; i--) {
+				r[i - 1 + units] = r[i - 1];
+			}
+		}
+		LimbKernels::zero(r, units);
+		this->normalize();
+	}
+
+	/* Divides by 2^count rounding towards negative infinity, the arithmetic shift of the two's complement form */
+	constexpr void shift_right(uint64_t count) {
+		auto& limbs = this->integer_storage();
+		uint64_t n = limbs.size();
+		uint64_t units = count / LimbKernels::unit_bits;
+		uint64_t bits = count % LimbKernels::unit_bits;
+		BIGNUMBER_INSTRUMENT(shift, n);
+
+		/* Negative numbers move one further down when any bit set in the magnitude is shifted out */
+		const unit_type* a = std::as_const(limbs).data();
+		bool round = this->state().is_negative &&
+					 (LimbKernels::normalized_size(a, std::min(units, n)) != 0 ||
+					  (units < n && bits != 0 && (a[units] << (LimbKernels::unit_bits - bits)) != 0));
+
+		if (units >= n) {
+			limbs.clear();
+		} else {
+			unit_type* r = limbs.data();
+			if (bits != 0) {
+				LimbKernels::rshift(r, r + units, n - units, bits);
+			} else {
+				for (uint64_t i = 0; i < n - units; i++) {
+					r[i] = r[i + units];
+				}
+			}
+			limbs.resize(n - units);
+		}
+
+		if (round && LimbKernels::increment(limbs.data(), limbs.size(), 1) != 0) {
+			limbs.push_back(1);
+		}
+		this->normalize();
+	}
+
+	static constexpr uint64_t shift_count(const BigInteger& count) {
+		if (count.state().is_negative || count.integer_storage().size() > 1) {
+			throw ArithmeticException("Shift count must be a non negative 64 bit value.");
+		}
+		return count.integer_storage().empty() ? 0 : count.integer_storage().front();
+	}
+
+	template<Integer T>
+	static constexpr uint64_t shift_count(T count) {
+		if constexpr (std::is_signed_v<T>) {
+			if (count < 0) {
+				throw ArithmeticException("Shift count must be a non negative 64 bit value.");
+			}
+		}
+		return static_cast<uint64_t>(count);
+	}
+
+	/* Writes the magnitude of the product of two non zero numbers to r, passing the same limbs twice squares */
+	template<typename Kernel>
+	static constexpr void multiply_into(unit_type* r, BigIntegerView first, BigIntegerView second, Kernel kernel) {
+		if (first.size() < second.size()) {
+			std::swap(first, second);
+		}
+		kernel(r, first.data(), first.size(), second.data(), second.size());
+	}
+
+	template<typename Kernel>
+	static constexpr BigInteger multiply(BigIntegerView first, BigIntegerView second, Kernel kernel) {
+		BIGNUMBER_INSTRUMENT(multiply, std::max(first.size(), second.size()));
+		BigInteger result;
+		if (!first || !second) {
+			return result;
+		}
+
+		result.integer_storage().resize(first.size() + second.size());
+		BigInteger::multiply_into(result.integer_storage().data(), first, second, kernel);
+		result.state().is_negative = first.is_negative() != second.is_negative();
+		result.normalize();
+		return result;
+	}
+
+	template<typename Kernel>
+	static constexpr BigInteger multiply(const BigInteger& first, const BigInteger& second, Kernel kernel) {
+		return BigInteger::multiply(first.view(), second.view(), kernel);
+	}
+
+	[[nodiscard]] constexpr uint64_t significant_bits() const {
+		const auto& limbs = this->integer_storage();
+		if (limbs.empty()) {
+			return 0;
+		}
+		return limbs.size() * LimbKernels::unit_bits - static_cast<uint64_t>(std::countl_zero(limbs.back()));
+	}
+
+	/* Index of the lowest non zero limb of a non zero number */
+	[[nodiscard]] constexpr uint64_t lowest_limb() const {
+		const auto& limbs = this->integer_storage();
+		uint64_t index = 0;
+		while (limbs[index] == 0) {
+			index++;
+		}
+		return index;
+	}
+
+	/* Number of zero bits below the lowest set bit of a non zero number */
+	[[nodiscard]] constexpr uint64_t trailing_zeros() const {
+		uint64_t index = this->lowest_limb();
+		return index * LimbKernels::unit_bits + static_cast<uint64_t>(std::countr_zero(this->integer_storage()[index]));
+	}
+
+	/* number mod 2^bits for a non negative number */
+	[[nodiscard]] static constexpr BigInteger low_bits(const BigInteger& number, uint64_t bits) {
+		const auto& limbs = number.integer_storage();
+		uint64_t units = std::min(limbs.size(), (bits + LimbKernels::unit_bits - 1) / LimbKernels::unit_bits);
+		BigInteger result;
+		result.integer_storage().assign(limbs.begin(), limbs.begin() + static_cast<int64_t>(units));
+		if (units * LimbKernels::unit_bits > bits) {
+			result.integer_storage().back() &= (unit_type(1) << (bits % LimbKernels::unit_bits)) - 1;
+		}
+		result.normalize();
+		return result;
+	}
+
+	template<Integer T>
+	static constexpr uint64_t exponent_value(T exponent) {
+		if constexpr (std::is_signed_v<T>) {
+			if (exponent < 0) {
+				throw ArithmeticException("Exponent must be non negative.");
+			}
+		}
+		return static_cast<uint64_t>(exponent);
+	}
+
+	/* Magnitude of base^exponent for |base| > 1 and a positive exponent, left to right over windows of the exponent bits */
+	static constexpr BigInteger power(const BigInteger& base, uint64_t exponent) {
+		BIGNUMBER_INSTRUMENT(power, base.integer_storage().size());
+		uint64_t base_bits = base.significant_bits();
+		if (base_bits > std::numeric_limits<uint64_t>::max() / exponent) {
+			throw ArithmeticException("Power is too large.");
+		}
+
+		uint64_t bits = LimbKernels::unit_bits - static_cast<uint64_t>(std::countl_zero(exponent));
+		uint64_t window = bits > 32 ? 4 : bits > 12 ? 3 : bits > 4 ? 2 : 1;
+
+		/* Odd powers base, base^3, ..., base^(2^window - 1) */
+		std::vector<BigInteger> table(uint64_t(1) << (window - 1));
+		table[0] = BigInteger::abs(base);
+		if (table.size() > 1) {
+			BigInteger square = table[0] * table[0];
+			for (uint64_t i = 1; i < table.size(); i++) {
+				table[i] = table[i - 1] * square;
+			}
+		}
+
+		/* Every partial power divides the result, so both buffers fit any intermediate product */
+		uint64_t size = base_bits * exponent / LimbKernels::unit_bits + 2;
+		BigInteger result;
+		storage_type scratch;
+		result.integer_storage().resize(size);
+		scratch.resize(size);
+		unit_type* r = result.integer_storage().data();
+		unit_type* t = scratch.data();
+		uint64_t n = 0;
+
+		auto square = [&r, &t, &n]() {
+			Multiplication::mul(t, r, n, r, n);
+			n = LimbKernels::normalized_size(t, 2 * n);
+			std::swap(r, t);
+		};
+
+		for (uint64_t i = bits; i > 0;) {
+			if (((exponent >> (i - 1)) & 1U) == 0) {
+				square();
+				i -= 1;
+				continue;
+			}
+
+			uint64_t low = i > window ? i - window : 0;
+			while (((exponent >> low) & 1U) == 0) {
+				low += 1;
+			}
+
+			const auto& entry = table[((exponent >> low) & ((uint64_t(1) << (i - low)) - 1)) >> 1].integer_storage();
+			if (n == 0) {
+				LimbKernels::copy(r, entry.data(), entry.size());
+				n = entry.size();
+			} else {
+				for (uint64_t j = low; j < i; j++) {
+					square();
+				}
+				if (n >= entry.size()) {
+					Multiplication::mul(t, r, n, entry.data(), entry.size());
+				} else {
+					Multiplication::mul(t, entry.data(), entry.size(), r, n);
+				}
+				n = LimbKernels::normalized_size(t, n + entry.size());
+				std::swap(r, t);
+			}
+			i = low;
+		}
+
+		if (r != result.integer_storage().data()) {
+			LimbKernels::copy(result.integer_storage().data(), r, n);
+		}
+		result.integer_storage().resize(n);
+		return result;
+	}
+
+	/* Largest r with r^k <= number for a positive number, Newton's iteration from above seeded by the root of the leading half */
+	static constexpr BigInteger root(const BigInteger& number, uint64_t k) {
+		BIGNUMBER_INSTRUMENT(root, number.integer_storage().size());
+		uint64_t bits = number.significant_bits();
+		if (k >= bits) {
+			/* The number is below 2^k, this also keeps 2 * k from wrapping and pow from building huge powers */
+			return 1;
+		}
+
+		if (bits < 2 * k) {
+			/* The root is below four */
+			BigInteger result = 1;
+			while (BigInteger::pow(result + 1, k) <= number) {
+				result += 1;
+			}
+			return result;
+		}
+
+		uint64_t shift = bits / (2 * k);
+		BigInteger x = (BigInteger::root(number >> (shift * k), k) + 1) << shift;
+		BigInteger degree = k;
+		while (true) {
+			BigInteger y = (x * (degree - 1) + number / BigInteger::pow(x, k - 1)) / degree;
+			if (y >= x) {
+				return x;
+			}
+
+			/* Every iterate stays at or above the root, so one that does not exceed it is the root */
+			if (BigInteger::pow(y, k) <= number) {
+				return y;
+			}
+			x = std::move(y);
+		}
+	}
+
+	/* base^exponent mod 2^bits by square and multiply, truncating every intermediate product */
+	static constexpr BigInteger truncated_power(const BigInteger& base, uint64_t exponent, const BigInteger& mask) {
+		BigInteger result = 1;
+		for (uint64_t i = LimbKernels::unit_bits - static_cast<uint64_t>(std::countl_zero(exponent)); i > 0; i--) {
+			result = result * result & mask;
+			if (((exponent >> (i - 1)) & 1U) != 0) {
+				result = result * base & mask;
+			}
+		}
+		return result;
+	}
+
+	/*
+	 * The only possible k-th root of an odd number of the given bit count for an odd k, found 2-adically: Newton's
+	 * iteration lifts y = number^(-1/k) one doubling of precision at a time up to the bits of the root, then the root is
+	 * number * y^(k - 1). The caller verifies the candidate.
+	 */
+	static constexpr BigInteger odd_root_candidate(const BigInteger& number, uint64_t k, uint64_t bits) {
+		uint64_t root_bits = (bits + k - 1) / k;
+		BigInteger low = BigInteger::low_bits(number, root_bits);
+		BigInteger y = 1, inverse = 1, mask = 1;
+		for (uint64_t precision = 1; precision < root_bits;) {
+			precision = std::min(2 * precision, root_bits);
+			mask = (BigInteger(1) << precision) - 1;
+			inverse = inverse * (BigInteger(2) - inverse * k) & mask;
+			BigInteger error = BigInteger(1) - (low & mask) * BigInteger::truncated_power(y, k, mask);
+			y = (y + y * (error & mask) * inverse) & mask;
+		}
+
+		mask = (BigInteger(1) << root_bits) - 1;
+		return (low & mask) * BigInteger::truncated_power(y, k - 1, mask) & mask;
+	}
+
+	/* Whether the odd number is a perfect square, after rejecting quadratic non residues modulo 8, 63, 65 and 11 */
+	static constexpr bool is_odd_square(const BigInteger& number) {
+		BigInteger rest = number % 45045;
+		uint64_t residue = rest.integer_storage().empty() ? 0 : rest.integer_storage().front();
+		for (uint64_t modulus : {63, 65, 11}) {
+			bool square = false;
+			for (uint64_t i = 0; i < modulus && !square; i++) {
+				square = i * i % modulus == residue % modulus;
+			}
+			if (!square) {
+				return false;
+			}
+		}
+
+		if ((number.integer_storage().front() & 7U) != 1) {
+			return false;
+		}
+		BigInteger root = BigInteger::root(number, 2);
+		return root * root == number;
+	}
+
+	/* Unbounded counterpart of GreatestCommonDivisor::Matrix, a template only because this class is still incomplete here */
+	template<typename Entry>
+	struct GcdMatrix {
+		Entry m00 = 1;
+		Entry m01 = 0;
+		Entry m10 = 0;
+		Entry m11 = 1;
+		bool negative = false;
+	};
+
+	/* (x, y) = M^-1 (x, y), the adjugate of M with the sign of its determinant */
+	template<typename Matrix>
+	static constexpr void apply_inverse(const Matrix& m, BigInteger& x, BigInteger& y) {
+		BigInteger first = BigInteger(m.m11) * x - BigInteger(m.m01) * y;
+		BigInteger second = BigInteger(m.m00) * y - BigInteger(m.m10) * x;
+		x = m.negative ? -std::move(first) : std::move(first);
+		y = m.negative ? -std::move(second) : std::move(second);
+	}
+
+	/* m = m n */
+	template<typename Matrix>
+	static constexpr void multiply_matrices(GcdMatrix<BigInteger>& m, const Matrix& n) {
+		BigInteger n00 = n.m00, n01 = n.m01, n10 = n.m10, n11 = n.m11;
+		BigInteger m00 = m.m00 * n00 + m.m01 * n10;
+		BigInteger m10 = m.m10 * n00 + m.m11 * n10;
+		m.m01 = m.m00 * n01 + m.m01 * n11;
+		m.m11 = m.m10 * n01 + m.m11 * n11;
+		m.m00 = std::move(m00);
+		m.m10 = std::move(m10);
+		m.negative = m.negative != n.negative;
+	}
+
+	/* (a, b) = M^-1 (a, b) for a Lehmer matrix, through the limb kernel and the scratch numbers alpha and beta */
+	static constexpr void apply_lehmer(BigInteger& a, BigInteger& b, const GreatestCommonDivisor::Matrix& m,
+									   BigInteger& alpha, BigInteger& beta) {
+		uint64_t n = std::max(a.integer_storage().size(), b.integer_storage().size());
+		a.integer_storage().resize(n);
+		b.integer_storage().resize(n);
+		alpha.integer_storage().resize(n);
+		beta.integer_storage().resize(n);
+		GreatestCommonDivisor::apply(alpha.integer_storage().data(), beta.integer_storage().data(),
+									 a.integer_storage().data(), b.integer_storage().data(), n, m);
+		alpha.normalize();
+		beta.normalize();
+		std::swap(a, alpha);
+		std::swap(b, beta);
+	}
+
+	/* Lehmer matrix of the leading bits of a and b, which must not be below 2^s (counting from 0 for no bound) afterwards */
+	static constexpr bool lehmer_matrix(GreatestCommonDivisor::Matrix& m, const BigInteger& a, const BigInteger& b, uint64_t s) {
+		uint64_t bits = a.significant_bits();
+		uint64_t shift = bits > GreatestCommonDivisor::lehmer_bits ? bits - GreatestCommonDivisor::lehmer_bits : 0;
+		if (s >= shift + GreatestCommonDivisor::lehmer_bits) {
+			return false;
+		}
+
+		using next_type = GreatestCommonDivisor::next_type;
+		next_type minimum = s == 0 ? 0 : s > shift ? next_type(1) << (s - shift) : 1;
+		const auto& first = a.integer_storage();
+		const auto& second = b.integer_storage();
+		return GreatestCommonDivisor::lehmer(m, GreatestCommonDivisor::extract(first.data(), first.size(), shift),
+											 GreatestCommonDivisor::extract(second.data(), second.size(), shift),
+											 shift == 0, minimum);
+	}
+
+	/* One step that subtracts a multiple of the smaller number while both stay at or above floor, false once |a - b| < floor */
+	static constexpr bool half_gcd_step(BigInteger& a, BigInteger& b, GcdMatrix<BigInteger>& m, const BigInteger& floor) {
+		bool swapped = a < b;
+		BigInteger& larger = swapped ? b : a;
+		const BigInteger& smaller = swapped ? a : b;
+		BigInteger q = (larger - floor) / smaller;
+		if (!q) {
+			return false;
+		}
+
+		larger -= q * smaller;
+		if (swapped) {
+			m.m00 += q * m.m01;
+			m.m10 += q * m.m11;
+		} else {
+			m.m01 += q * m.m00;
+			m.m11 += q * m.m10;
+		}
+		return true;
+	}
+
+	/* Quadratic half gcd, Lehmer steps while the leading bits decide the quotients and single steps near the bound */
+	static constexpr bool half_gcd_basecase(BigInteger& a, BigInteger& b, GcdMatrix<BigInteger>& m, uint64_t s) {
+		BigInteger floor = BigInteger(1) << s;
+		BigInteger alpha, beta;
+		GreatestCommonDivisor::Matrix lehmer;
+		bool progress = false;
+
+		while (true) {
+			if (a < b) {
+				std::swap(a, b);
+				std::swap(m.m00, m.m01);
+				std::swap(m.m10, m.m11);
+				m.negative = !m.negative;
+			}
+
+			if (BigInteger::lehmer_matrix(lehmer, a, b, s)) {
+				BigInteger::apply_lehmer(a, b, lehmer, alpha, beta);
+				BigInteger::multiply_matrices(m, lehmer);
+			} else if (!BigInteger::half_gcd_step(a, b, m, floor)) {
+				return progress;
+			}
+			progress = true;
+		}
+	}
+
+	/*
+	 * Half gcd of the bits of a and b above shift, applied to the full numbers. The reduced leading bits are already
+	 * known, so the matrix only has to be applied to the low bits.
+	 */
+	static constexpr bool half_gcd_high(BigInteger& a, BigInteger& b, GcdMatrix<BigInteger>& m, uint64_t shift) {
+		BigInteger high_a = a >> shift;
+		BigInteger high_b = b >> shift;
+		if (!BigInteger::half_gcd(high_a, high_b, m)) {
+			return false;
+		}
+
+		BigInteger low_a = BigInteger::low_bits(a, shift);
+		BigInteger low_b = BigInteger::low_bits(b, shift);
+		BigInteger::apply_inverse(m, low_a, low_b);
+		a = (high_a << shift) + low_a;
+		b = (high_b << shift) + low_b;
+		return true;
+	}
+
+	/*
+	 * Möller's half gcd. For positive a and b of at most n bits and s = n / 2 + 1, finds m with (a, b) = m (alpha, beta)
+	 * where alpha and beta are at least 2^s and differ by less than 2^s, and replaces a and b by them. Both recursive
+	 * calls work on leading bits only, which is safe because any such reduction of the leading bits stays valid for the
+	 * full numbers. m must be the identity on entry. Returns whether any step was taken, none is when a or b is below
+	 * 2^s or they already differ by less.
+	 */
+	static constexpr bool half_gcd(BigInteger& a, BigInteger& b, GcdMatrix<BigInteger>& m) {
+		uint64_t n = std::max(a.significant_bits(), b.significant_bits());
+		uint64_t s = n / 2 + 1;
+		if (std::min(a.significant_bits(), b.significant_bits()) <= s || (a - b).significant_bits() <= s) {
+			return false;
+		}
+
+		if (n < GreatestCommonDivisor::half_gcd_threshold * LimbKernels::unit_bits) {
+			return BigInteger::half_gcd_basecase(a, b, m, s);
+		}
+
+		bool progress = BigInteger::half_gcd_high(a, b, m, n / 2);
+
+		BigInteger floor = BigInteger(1) << s;
+		while (std::max(a.significant_bits(), b.significant_bits()) > 3 * n / 4 + 1 && BigInteger::half_gcd_step(a, b, m, floor)) {
+			progress = true;
+		}
+
+		GcdMatrix<BigInteger> second;
+		if (BigInteger::half_gcd_high(a, b, second, 2 * s - std::max(a.significant_bits(), b.significant_bits()))) {
+			BigInteger::multiply_matrices(m, second);
+			progress = true;
+		}
+
+		while (BigInteger::half_gcd_step(a, b, m, floor)) {
+			progress = true;
+		}
+		return progress;
+	}
+
+	/*
+	 * gcd of the non negative a and b: the half gcd for large operands, Lehmer's algorithm for medium ones and the binary
+	 * gcd once b fits a word. With a cofactor it also finds u with u * a + v * b = gcd, carrying the first column of the
+	 * inverse of the accumulated matrix along.
+	 */
+	static constexpr BigInteger gcd_magnitudes(BigInteger a, BigInteger b, BigInteger* cofactor) {
+		BIGNUMBER_INSTRUMENT(gcd, std::max(a.integer_storage().size(), b.integer_storage().size()));
+		BigInteger u0 = 1, u1 = 0;
+		BigInteger alpha, beta;
+		GreatestCommonDivisor::Matrix lehmer;
+
+		while (true) {
+			if (a < b) {
+				std::swap(a, b);
+				std::swap(u0, u1);
+			}
+
+			uint64_t bn = b.integer_storage().size();
+			if (bn == 0) {
+				break;
+			}
+
+			if (bn == 1 && cofactor == nullptr) {
+				unit_type d = b.integer_storage().front();
+				return GreatestCommonDivisor::gcd_1(d, LimbKernels::mod_1(a.integer_storage().data(), a.integer_storage().size(), d));
+			}
+
+			if (bn >= GreatestCommonDivisor::half_gcd_threshold) {
+				GcdMatrix<BigInteger> m;
+				if (BigInteger::half_gcd(a, b, m)) {
+					if (cofactor != nullptr) {
+						BigInteger::apply_inverse(m, u0, u1);
+					}
+					continue;
+				}
+			} else if (BigInteger::lehmer_matrix(lehmer, a, b, 0)) {
+				BigInteger::apply_lehmer(a, b, lehmer, alpha, beta);
+				if (cofactor != nullptr) {
+					BigInteger::apply_inverse(lehmer, u0, u1);
+				}
+				continue;
+			}
+
+			auto [quotient, remainder] = BigInteger::divmod(a, b);
+			a = std::move(b);
+			b = std::move(remainder);
+			if (cofactor != nullptr) {
+				u0 -= quotient * u1;
+				std::swap(u0, u1);
+			}
+		}
+
+		if (cofactor != nullptr) {
+			*cofactor = std::move(u0);
+		}
+		return a;
+	}
+
+	/* Adds every term of sum, or subtracts them when negate is set, in the limbs of this number */
+	template<typename Expression>
+	constexpr void accumulate(const Expression& sum, bool negate) {
+		if (sum.refers_to(*this)) {
+			this->add_in_place(BigInteger(sum), negate);
+			return;
+		}
+
+		uint64_t size = this->integer_storage().size();
+		for (const Term& term : sum.terms_) {
+			uint64_t term_size = term.first->integer_storage().size();
+			if (term.second != nullptr) {
+				term_size += term.second->integer_storage().size();
+			}
+			size = std::max(size, term_size);
+		}
+		this->integer_storage().reserve(size + 1);
+
+		for (const Term& term : sum.terms_) {
+			if (term.second == nullptr) {
+				this->add_in_place(*term.first, term.negate != negate);
+			} else {
+				this->addmul_in_place(*term.first, *term.second, term.negate != negate);
+			}
+		}
+	}
+
+	[[nodiscard]] constexpr int32_t compare_magnitudes(const BigInteger& other) const {
+		return LimbKernels::compare(this->integer_storage().data(), this->integer_storage().size(),
+									other.integer_storage().data(), other.integer_storage().size());
+	}
+
+	/* Word i of the infinite two's complement representation, carry starts at 1 for negative numbers */
+	constexpr unit_type twos_complement_unit(uint64_t index, unit_type& carry) const {
+		unit_type unit = index < this->integer_storage().size() ? this->integer_storage()[index] : 0;
+		if (!this->state().is_negative) {
+			return unit;
+		}
+		unit = ~unit + carry;
+		carry = carry && unit == 0;
+		return unit;
+	}
+
+	/* Word i of the infinite two's complement representation without walking the words below, lowest is lowest_limb() for negative numbers */
+	[[nodiscard]] constexpr unit_type twos_complement_limb(uint64_t index, uint64_t lowest) const {
+		const auto& limbs = this->integer_storage();
+		unit_type limb = index < limbs.size() ? limbs[index] : 0;
+		if (!this->state().is_negative || index < lowest) {
+			return limb;
+		}
+		return index == lowest ? 0 - limb : ~limb;
+	}
+
+	/* Adds 2^bit to the magnitude, or subtracts it when subtract is set, which needs the magnitude to be at least 2^bit */
+	constexpr void add_magnitude_bit(uint64_t bit, bool subtract) {
+		auto& limbs = this->integer_storage();
+		uint64_t units = bit / LimbKernels::unit_bits;
+		unit_type limb = unit_type(1) << (bit % LimbKernels::unit_bits);
+
+		if (subtract) {
+			LimbKernels::decrement(limbs.data() + units, limbs.size() - units, limb);
+			this->normalize();
+			return;
+		}
+
+		if (limbs.size() <= units) {
+			limbs.resize(units + 1);
+		}
+		if (LimbKernels::increment(limbs.data() + units, limbs.size() - units, limb) != 0) {
+			limbs.push_back(1);
+		}
+	}
+
+	/* Combines the infinite two's complement representations limb by limb in place, other may alias this */
+	template<typename Operation>
+	constexpr void bitwise(const BigInteger& other, Operation operation) {
+		auto& limbs = this->integer_storage();
+		uint64_t size = std::max(limbs.size(), other.integer_storage().size()) + 1;
+		BIGNUMBER_INSTRUMENT(bitwise, size - 1);
+		unit_type this_carry = 1, other_carry = 1, result_carry = 1;
+
+		limbs.resize(size);
+		unit_type* r = limbs.data();
+		for (uint64_t i = 0; i < size; i++) {
+			unit_type first = this->twos_complement_unit(i, this_carry);
+			r[i] = operation(first, other.twos_complement_unit(i, other_carry));
+		}
+
+		this->state().is_negative = (limbs.back() >> (LimbKernels::unit_bits - 1)) != 0;
+		if (this->state().is_negative) {
+			for (auto & unit : limbs) {
+				unit = ~unit + result_carry;
+				result_carry = result_carry && unit == 0;
+			}
+		}
+
+		this->normalize();
+	}
+
+	/* Term of a lazy expression, second is null for a plain number */
+	struct Term {
+		const BigInteger* first = nullptr;
+		const BigInteger* second = nullptr;
+		bool negate = false;
+	};
+
+	/* Adds first * second, or subtracts it when negate is set, in the limbs of this number, neither may alias it */
+	constexpr void addmul_in_place(const BigInteger& first, const BigInteger& second, bool negate) {
+		const auto& a = first.integer_storage();
+		const auto& b = second.integer_storage();
+		if (a.empty() || b.empty()) {
+			return;
+		}
+
+		BIGNUMBER_INSTRUMENT(multiply, std::max(a.size(), b.size()));
+		auto& limbs = this->integer_storage();
+		uint64_t n = limbs.size();
+		uint64_t pn = a.size() + b.size();
+		bool product_negative = (first.state().is_negative != second.state().is_negative) != negate;
+		storage_type scratch;
+		if (n != 0 && std::min(a.size(), b.size()) >= Multiplication::karatsuba_threshold) {
+			scratch.resize(pn);
+		}
+
+		limbs.resize(std::max(n, pn) + 1);
+		if (n == 0) {
+			BigInteger::multiply_into(limbs.data(), first.view(), second.view(), Multiplication::mul);
+			this->state().is_negative = product_negative;
+		} else if ((this->state().is_negative != 0) == product_negative) {
+			Multiplication::addmul(limbs.data(), limbs.size(), a.data(), a.size(), b.data(), b.size(), scratch.data());
+		} else if (Multiplication::submul(limbs.data(), limbs.size(), a.data(), a.size(), b.data(), b.size(), scratch.data()) != 0) {
+			/* The product was the larger one, the limbs hold the difference in two's complement */
+			for (auto& unit : limbs) {
+				unit = ~unit;
+			}
+			LimbKernels::increment(limbs.data(), limbs.size(), 1);
+			this->state().is_negative = product_negative;
+		}
+
+		this->normalize();
+	}
+
+public:
+
+	/*
+	 * Lazy signed sum of N terms, each a number or the product of two numbers, built by multiplying lvalues and by adding
+	 * or subtracting such expressions. Converting it to a number evaluates every term into a single buffer with fused
+	 * multiply-add kernels. It refers to its operands, so expressions involving temporaries are evaluated eagerly.
+	 */
+	template<uint64_t N>
+	class Sum {
+		friend class BigInteger;
+		template<uint64_t> friend class Sum;
+
+		std::array<Term, N> terms_;
+
+		constexpr Sum() = default;
+
+		constexpr explicit Sum(const BigInteger& number) requires (N == 1) : terms_{Term{&number, nullptr, false}} {}
+
+		constexpr Sum(const BigInteger& first, const BigInteger& second) requires (N == 1) : terms_{Term{&first, &second, false}} {}
+
+		template<uint64_t M>
+		[[nodiscard]] constexpr Sum<N + M> join(const Sum<M>& other, bool negate) const {
+			Sum<N + M> result;
+			std::copy(this->terms_.begin(), this->terms_.end(), result.terms_.begin());
+			for (uint64_t i = 0; i < M; i++) {
+				result.terms_[N + i] = other.terms_[i];
+				result.terms_[N + i].negate = other.terms_[i].negate != negate;
+			}
+			return result;
+		}
+
+		[[nodiscard]] constexpr bool refers_to(const BigInteger& number) const {
+			return std::any_of(this->terms_.begin(), this->terms_.end(),
+							   [&number](const Term& term) { return term.first == &number || term.second == &number; });
+		}
+
+	public:
+
+		constexpr operator BigInteger() const {
+			BigInteger result;
+			result.accumulate(*this, false);
+			return result;
+		}
+
+		constexpr Sum operator-() const {
+			return Sum<0>().join(*this, true);
+		}
+
+		template<uint64_t M>
+		friend constexpr Sum<N + M> operator+(const Sum& first, const Sum<M>& second) {
+			return first.join(second, false);
+		}
+
+		template<uint64_t M>
+		friend constexpr Sum<N + M> operator-(const Sum& first, const Sum<M>& second) {
+			return first.join(second, true);
+		}
+
+		friend constexpr Sum<N + 1> operator+(const Sum& first, const BigInteger& second) {
+			return first.join(Sum<1>(second), false);
+		}
+
+		friend constexpr Sum<N + 1> operator-(const Sum& first, const BigInteger& second) {
+			return first.join(Sum<1>(second), true);
+		}
+
+		friend constexpr Sum<N + 1> operator+(const BigInteger& first, const Sum& second) {
+			return Sum<1>(first).join(second, false);
+		}
+
+		friend constexpr Sum<N + 1> operator-(const BigInteger& first, const Sum& second) {
+			return Sum<1>(first).join(second, true);
+		}
+
+		/* Temporaries take the result in their own limbs */
+		friend constexpr BigInteger operator+(const Sum& first, BigInteger&& second) {
+			second += first;
+			return std::move(second);
+		}
+
+		friend constexpr BigInteger operator-(const Sum& first, BigInteger&& second) {
+			second -= first;
+			return -std::move(second);
+		}
+
+		friend constexpr BigInteger operator+(BigInteger&& first, const Sum& second) {
+			first += second;
+			return std::move(first);
+		}
+
+		friend constexpr BigInteger operator-(BigInteger&& first, const Sum& second) {
+			first -= second;
+			return std::move(first);
+		}
+
+		DECLARE_EVALUATING_OPERATOR(*)
+		DECLARE_EVALUATING_OPERATOR(/)
+		DECLARE_EVALUATING_OPERATOR(%)
+		DECLARE_EVALUATING_OPERATOR(<<)
+		DECLARE_EVALUATING_OPERATOR(>>)
+		DECLARE_EVALUATING_OPERATOR(&)
+		DECLARE_EVALUATING_OPERATOR(|)
+		DECLARE_EVALUATING_OPERATOR(^)
+
+		friend constexpr bool operator==(const Sum& first, const BigInteger& second) {
+			return BigInteger(first) == second;
+		}
+
+		template<uint64_t M>
+		friend constexpr bool operator==(const Sum& first, const Sum<M>& second) {
+			return BigInteger(first) == BigInteger(second);
+		}
+
+		friend constexpr std::strong_ordering operator<=>(const Sum& first, const BigInteger& second) {
+			return BigInteger(first) <=> second;
+		}
+
+		template<uint64_t M>
+		friend constexpr std::strong_ordering operator<=>(const Sum& first, const Sum<M>& second) {
+			return BigInteger(first) <=> BigInteger(second);
+		}
+
+		friend std::ostream& operator<<(std::ostream& os, const Sum& sum) {
+			return os << BigInteger(sum);
+		}
+	};
+
+	using Product = Sum<1>;
+
+	[[maybe_unused]] static constexpr BigInteger ZERO() {
+        return 0;
+    }
+
+    [[maybe_unused]] static constexpr BigInteger ONE() {
+        return 1;
+    }
+
+    [[maybe_unused]] static constexpr BigInteger TEN() {
+        return 10;
+    }
+
+	explicit BigInteger(const std::string& number) : BigNumber(number) {
+		this->check_number(number);
+		this->parse(number);
+	}
+	
+	constexpr BigInteger() = default;
+	constexpr BigInteger(const BigInteger&) = default;
+	constexpr BigInteger(BigInteger&&) = default;
+	constexpr BigInteger& operator=(const BigInteger&) = default;
+	constexpr BigInteger& operator=(BigInteger&&) = default;
+	
+	template<Integer T>
+	constexpr BigInteger(T value) : BigNumber() {
+		using unsigned_type = unsigned_integer_t<T>;
+		auto magnitude = static_cast<unsigned_type>(value);
+
+		if constexpr (std::is_signed_v<T>) {
+			if (value < 0) {
+				this->state().is_negative = 1;
+				magnitude = static_cast<unsigned_type>(0 - magnitude);
+			}
+		}
+
+		while (magnitude != 0) {
+			this->integer_storage().push_back(static_cast<unit_type>(magnitude));
+			if constexpr (sizeof(unsigned_type) > sizeof(unit_type)) {
+				magnitude >>= LimbKernels::unit_bits;
+			} else {
+				magnitude = 0;
+			}
+		}
+	}
+	
+	/* Copy of the limbs a view refers to */
+	constexpr explicit BigInteger(BigIntegerView number) : BigNumber() {
+		this->integer_storage().assign(number.data(), number.data() + number.size());
+		this->state().is_negative = number.is_negative();
+	}
+
+	/* Number encoded at the front of bytes in one of the forms of Serialization */
+	[[nodiscard]] static BigInteger deserialize(std::span<const std::byte> bytes) {
+		Serialization::Header header = Serialization::read_header(bytes);
+		BigInteger number;
+		auto& limbs = number.integer_storage();
+		limbs.resize(header.limbs);
+		limbs.resize(Serialization::read_limbs(limbs.data(), bytes, header));
+		number.state().is_negative = header.negative;
+		return number;
+	}
+
+	/*
+	 * Skips leading whitespace and reads an optional '-' and the digits after it, stopping before the first other
+	 * character. Sets failbit when there is no digit. The text goes through a BigIntegerReader, never whole.
+	 */
+	friend std::istream& operator>>(std::istream& is, BigInteger& number) {
+		std::istream::sentry sentry(is);
+		if (!sentry) {
+			return is;
+		}
+
+		constexpr uint64_t chunk_size = 4096;
+		std::array<char, chunk_size> chunk;
+		uint64_t size = 0;
+		bool digits = false;
+		BigIntegerReader reader;
+		std::streambuf* buffer = is.rdbuf();
+
+		int32_t character = buffer->sgetc();
+		if (character == '-') {
+			chunk[size++] = '-';
+			character = buffer->snextc();
+		}
+		while (character >= '0' && character <= '9') {
+			chunk[size++] = static_cast<char>(character);
+			digits = true;
+			if (size == chunk_size) {
+				reader.feed({chunk.data(), size});
+				size = 0;
+			}
+			character = buffer->snextc();
+		}
+
+		if (character == std::char_traits<char>::eof()) {
+			is.setstate(std::ios::eofbit);
+		}
+		if (!digits) {
+			is.setstate(std::ios::failbit);
+			return is;
+		}
+
+		reader.feed({chunk.data(), size});
+		number = BigInteger(reader.finish());
+		return is;
+	}
+
+	/* Read only view of the limbs, valid until the number changes */
+	[[nodiscard]] constexpr BigIntegerView view() const {
+		return {{this->integer_storage().data(), this->integer_storage().size()}, this->state().is_negative != 0};
+	}
+
+	/* Counters of every operation since the start or Instrumentation::reset(), empty unless built with BIGNUMBER_INSTRUMENTATION */
+	[[nodiscard]] static Instrumentation::Snapshot stats() {
+		return Instrumentation::snapshot();
+	}
+
+	[[nodiscard]] static constexpr BigInteger abs(const BigInteger& number) {
+		BigInteger abs_number = number;
+		abs_number.state().is_negative = 0;
+		return abs_number;
+	} 
+
+	constexpr BigInteger& operator+=(const BigInteger& other) {
+		this->add_in_place(other, false);
+		return *this;
+	}
+
+	constexpr BigInteger& operator-=(const BigInteger& other) {
+		this->add_in_place(other, true);
+		return *this;
+	}
+
+	constexpr BigInteger& operator*=(const BigInteger& other) {
+		if (other.integer_storage().size() == 1) {
+			this->multiply_limb(other.integer_storage().front(), other.state().is_negative);
+		} else {
+			*this = BigInteger::multiply(*this, other, Multiplication::mul);
+		}
+		return *this;
+	}
+
+	DECLARE_COMMUTATIVE_OPERATOR(+)
+	DECLARE_BINARY_OPERATOR(-)
+
+	/* a - b computed in the storage of b as -(b - a) */
+	constexpr BigInteger operator-(BigInteger&& other) const & {
+		other -= *this;
+		return -std::move(other);
+	}
+
+	constexpr BigInteger operator-(BigInteger&& other) && {
+		(*this) -= other;
+		return std::move(*this);
+	}
+
+	constexpr BigInteger operator-() const & {
+		return -BigInteger(*this);
+	}
+
+	constexpr BigInteger operator-() && {
+		if (!this->integer_storage().empty()) {
+			this->state().is_negative = !this->state().is_negative;
+		}
+		return std::move(*this);
+	}
+	
+	constexpr bool operator!() const {
+		return this->integer_storage().empty();
+	}
+
+	template<uint64_t N>
+	constexpr BigInteger& operator=(const Sum<N>& sum) {
+		if (sum.refers_to(*this)) {
+			return *this = BigInteger(sum);
+		}
+
+		this->integer_storage().clear();
+		this->normalize();
+		this->accumulate(sum, false);
+		return *this;
+	}
+
+	template<uint64_t N>
+	constexpr BigInteger& operator+=(const Sum<N>& sum) {
+		this->accumulate(sum, false);
+		return *this;
+	}
+
+	template<uint64_t N>
+	constexpr BigInteger& operator-=(const Sum<N>& sum) {
+		this->accumulate(sum, true);
+		return *this;
+	}
+
+	/* Products of lvalues are lazy so that adding them to other terms fuses the multiplication with the addition */
+	constexpr Product operator*(const BigInteger& other) const & {
+		return Product(*this, other);
+	}
+
+	constexpr BigInteger operator*(BigInteger&& other) const & {
+		other *= *this;
+		return std::move(other);
+	}
+
+	constexpr BigInteger operator*(const BigInteger& other) && {
+		(*this) *= other;
+		return std::move(*this);
+	}
+
+	constexpr BigInteger operator*(BigInteger&& other) && {
+		(*this) *= other;
+		return std::move(*this);
+	}
+
+	[[nodiscard]] static constexpr BigInteger multiply_ntt(const BigInteger& first, const BigInteger& second) {
+		return BigInteger::multiply(first, second, NumberTheoreticTransform::mul);
+	}
+
+	/* Product with the large multiplications split over the pool, from Multiplication::parallel_threshold limbs up */
+	[[nodiscard]] static BigInteger multiply(const BigInteger& first, const BigInteger& second, ThreadPool& pool) {
+		return BigInteger::multiply(first, second, [&pool](unit_type* r, const unit_type* a, uint64_t an, const unit_type* b, uint64_t bn) {
+			Multiplication::mul_parallel(r, a, an, b, bn, pool);
+		});
+	}
+
+	/* The parallel policies run on ThreadPool::global(), the others on the calling thread */
+	[[nodiscard]] static BigInteger multiply(const BigInteger& first, const BigInteger& second, const std::execution::parallel_policy&) {
+		return BigInteger::multiply(first, second, ThreadPool::global());
+	}
+
+	[[nodiscard]] static BigInteger multiply(const BigInteger& first, const BigInteger& second,
+											 const std::execution::parallel_unsequenced_policy&) {
+		return BigInteger::multiply(first, second, ThreadPool::global());
+	}
+
+	[[nodiscard]] static constexpr BigInteger multiply(const BigInteger& first, const BigInteger& second,
+													   const std::execution::sequenced_policy&) {
+		return BigInteger::multiply(first, second, Multiplication::mul);
+	}
+
+	[[nodiscard]] static constexpr BigInteger multiply(const BigInteger& first, const BigInteger& second,
+													   const std::execution::unsequenced_policy&) {
+		return BigInteger::multiply(first, second, Multiplication::mul);
+	}
+
+	/* Quotient truncated towards zero and remainder with the sign of the dividend */
+	[[nodiscard]] static constexpr std::pair<BigInteger, BigInteger> divmod(const BigInteger& dividend, const BigInteger& divisor) {
+		return BigInteger::divmod(dividend.view(), divisor.view());
+	}
+
+	[[nodiscard]] static constexpr std::pair<BigInteger, BigInteger> divmod(BigIntegerView dividend, BigIntegerView divisor) {
+		return BigInteger::divide(dividend, divisor, nullptr);
+	}
+
+	/* Quotient and remainder with the products of the recursive division split over the pool */
+	[[nodiscard]] static std::pair<BigInteger, BigInteger> divmod(const BigInteger& dividend, const BigInteger& divisor,
+																  ThreadPool& pool) {
+		return BigInteger::divide(dividend.view(), divisor.view(), &pool);
+	}
+
+	/* The parallel policies run on ThreadPool::global(), the others on the calling thread */
+	[[nodiscard]] static std::pair<BigInteger, BigInteger> divmod(const BigInteger& dividend, const BigInteger& divisor,
+																  const std::execution::parallel_policy&) {
+		return BigInteger::divmod(dividend, divisor, ThreadPool::global());
+	}
+
+	[[nodiscard]] static std::pair<BigInteger, BigInteger> divmod(const BigInteger& dividend, const BigInteger& divisor,
+																  const std::execution::parallel_unsequenced_policy&) {
+		return BigInteger::divmod(dividend, divisor, ThreadPool::global());
+	}
+
+	[[nodiscard]] static constexpr std::pair<BigInteger, BigInteger> divmod(const BigInteger& dividend, const BigInteger& divisor,
+																			const std::execution::sequenced_policy&) {
+		return BigInteger::divmod(dividend, divisor);
+	}
+
+	[[nodiscard]] static constexpr std::pair<BigInteger, BigInteger> divmod(const BigInteger& dividend, const BigInteger& divisor,
+																			const std::execution::unsequenced_policy&) {
+		return BigInteger::divmod(dividend, divisor);
+	}
+
+	constexpr BigInteger operator/(const BigInteger& other) const {
+		return BigInteger::divmod(*this, other).first;
+	}
+
+	constexpr BigInteger operator%(const BigInteger& other) const {
+		return BigInteger::divmod(*this, other).second;
+	}
+	
+	template<Integer T>
+	constexpr BigInteger& operator<<=(T count) {
+		this->shift_left(BigInteger::shift_count(count));
+		return *this;
+	}
+
+	/* Rounds towards negative infinity, so that -1 >> n stays -1 as in two's complement */
+	template<Integer T>
+	constexpr BigInteger& operator>>=(T count) {
+		this->shift_right(BigInteger::shift_count(count));
+		return *this;
+	}
+
+	template<Integer T>
+	constexpr BigInteger operator<<(T count) const & {
+		uint64_t bits = BigInteger::shift_count(count);
+		BigInteger result(*this, this->integer_storage().size() + bits / LimbKernels::unit_bits + 1);
+		result.shift_left(bits);
+		return result;
+	}
+
+	template<Integer T>
+	constexpr BigInteger operator<<(T count) && {
+		this->shift_left(BigInteger::shift_count(count));
+		return std::move(*this);
+	}
+
+	template<Integer T>
+	constexpr BigInteger operator>>(T count) const & {
+		BigInteger result(*this, this->integer_storage().size());
+		result.shift_right(BigInteger::shift_count(count));
+		return result;
+	}
+
+	template<Integer T>
+	constexpr BigInteger operator>>(T count) && {
+		this->shift_right(BigInteger::shift_count(count));
+		return std::move(*this);
+	}
+
+	constexpr BigInteger& operator<<=(const BigInteger& other) {
+		return (*this) <<= BigInteger::shift_count(other);
+	}
+
+	constexpr BigInteger& operator>>=(const BigInteger& other) {
+		return (*this) >>= BigInteger::shift_count(other);
+	}
+
+	constexpr BigInteger operator<<(const BigInteger& other) const & {
+		return (*this) << BigInteger::shift_count(other);
+	}
+
+	constexpr BigInteger operator<<(const BigInteger& other) && {
+		return std::move(*this) << BigInteger::shift_count(other);
+	}
+
+	constexpr BigInteger operator>>(const BigInteger& other) const & {
+		return (*this) >> BigInteger::shift_count(other);
+	}
+
+	constexpr BigInteger operator>>(const BigInteger& other) && {
+		return std::move(*this) >> BigInteger::shift_count(other);
+	}
+
+	constexpr BigInteger& operator&=(const BigInteger& other) {
+		this->bitwise(other, [](unit_type first, unit_type second) { return first & second; });
+		return *this;
+	}
+
+	constexpr BigInteger& operator|=(const BigInteger& other) {
+		this->bitwise(other, [](unit_type first, unit_type second) { return first | second; });
+		return *this;
+	}
+
+	constexpr BigInteger& operator^=(const BigInteger& other) {
+		this->bitwise(other, [](unit_type first, unit_type second) { return first ^ second; });
+		return *this;
+	}
+
+	DECLARE_COMMUTATIVE_OPERATOR(&)
+	DECLARE_COMMUTATIVE_OPERATOR(|)
+	DECLARE_COMMUTATIVE_OPERATOR(^)
+	
+	constexpr BigInteger operator~() const {
+		BigInteger result = -(*this);
+		result -= 1;
+		return result;
+	}
+
+	constexpr BigInteger& operator++() {
+		this->add_limb(1, false);
+		return *this;
+	}
+
+	constexpr BigInteger& operator--() {
+		this->add_limb(1, true);
+		return *this;
+	}
+
+	constexpr BigInteger operator++(int32_t) {
+		BigInteger copy = *this;
+		this->add_limb(1, false);
+		return copy;
+	}
+
+	constexpr BigInteger operator--(int32_t) {
+		BigInteger copy = *this;
+		this->add_limb(1, true);
+		return copy;
+	}
+	
+	constexpr bool operator==(const BigInteger& other) const {
+		BIGNUMBER_INSTRUMENT(compare, std::max(this->integer_storage().size(), other.integer_storage().size()));
+		return this->state().is_negative == other.state().is_negative &&
+			   this->integer_storage() == other.integer_storage();
+	}
+
+	constexpr std::strong_ordering operator<=>(const BigInteger& other) const {
+		BIGNUMBER_INSTRUMENT(compare, std::max(this->integer_storage().size(), other.integer_storage().size()));
+		if (this->state().is_negative != other.state().is_negative) {
+			return this->state().is_negative ? std::strong_ordering::less : std::strong_ordering::greater;
+		}
+
+		int32_t comparison = this->compare_magnitudes(other);
+		if (this->state().is_negative) {
+			comparison = -comparison;
+		}
+
+		return comparison <=> 0;
+	}
+
+	/* A view takes part in comparisons and as the right operand of arithmetic, it must not point into this number */
+
+	constexpr bool operator==(BigIntegerView other) const {
+		return this->view() == other;
+	}
+
+	constexpr std::strong_ordering operator<=>(BigIntegerView other) const {
+		return this->view() <=> other;
+	}
+
+	constexpr BigInteger& operator+=(BigIntegerView other) {
+		this->add_in_place(other, false);
+		return *this;
+	}
+
+	constexpr BigInteger& operator-=(BigIntegerView other) {
+		this->add_in_place(other, true);
+		return *this;
+	}
+
+	constexpr BigInteger& operator*=(BigIntegerView other) {
+		return *this = BigInteger::multiply(this->view(), other, Multiplication::mul);
+	}
+
+	constexpr BigInteger& operator/=(BigIntegerView other) {
+		return *this = BigInteger::divmod(this->view(), other).first;
+	}
+
+	constexpr BigInteger& operator%=(BigIntegerView other) {
+		return *this = BigInteger::divmod(this->view(), other).second;
+	}
+
+	constexpr BigInteger operator+(BigIntegerView other) const & {
+		BigInteger result(*this, std::max(this->integer_storage().size(), other.size()) + 1);
+		result += other;
+		return result;
+	}
+
+	constexpr BigInteger operator+(BigIntegerView other) && {
+		(*this) += other;
+		return std::move(*this);
+	}
+
+	constexpr BigInteger operator-(BigIntegerView other) const & {
+		BigInteger result(*this, std::max(this->integer_storage().size(), other.size()) + 1);
+		result -= other;
 		return result;
 	}
-	
-	constexpr void create_binary_from_decimal() {
-		this->binary_storage().clear();
-		this->binary_storage() = BigInteger::dec2bin(*this);
+
+	constexpr BigInteger operator-(BigIntegerView other) && {
+		(*this) -= other;
+		return std::move(*this);
 	}
-	
-	constexpr void create_decimal_from_binary() {
-		this->integer_storage().clear();
-		*this = BigInteger::bin2dec(this->binary_storage());
+
+	constexpr BigInteger operator*(BigIntegerView other) const {
+		return BigInteger::multiply(this->view(), other, Multiplication::mul);
 	}
 
+	constexpr BigInteger operator/(BigIntegerView other) const {
+		return BigInteger::divmod(this->view(), other).first;
+	}
 
-public:
+	constexpr BigInteger operator%(BigIntegerView other) const {
+		return BigInteger::divmod(this->view(), other).second;
+	}
 
-	[[maybe_unused]] static constexpr BigInteger ZERO() {
-        return 0;
-    }
+	/* Built in integers go through the single limb kernels in place instead of being converted to a number first */
 
-    [[maybe_unused]] static constexpr BigInteger ONE() {
-        return 1;
-    }
+	template<Integer T>
+	constexpr bool operator==(T value) const {
+		return this->view() == Scalar<T>(value).view();
+	}
 
-    [[maybe_unused]] static constexpr BigInteger TEN() {
-        return 10;
-    }
+	template<Integer T>
+	constexpr std::strong_ordering operator<=>(T value) const {
+		return this->view() <=> Scalar<T>(value).view();
+	}
 
-	explicit BigInteger(const std::string& number) : BigNumber(number) {
-		this->check_number(number);
-		this->parse(number);
+	template<Integer T>
+	constexpr BigInteger& operator+=(T value) {
+		Scalar<T> scalar(value);
+		if (scalar.is_limb()) {
+			this->add_limb(scalar.limbs[0], scalar.negative);
+		} else {
+			this->add_in_place(scalar.view(), false);
+		}
+		return *this;
 	}
-	
-	constexpr BigInteger() {
-        this->integer_storage().push_back(0);
-        this->binary_storage().push_back(0);
-    };
-	constexpr BigInteger(const BigInteger&) = default;
-	constexpr BigInteger(BigInteger&&) = default;
-	constexpr BigInteger& operator=(const BigInteger&) = default;
-	constexpr BigInteger& operator=(BigInteger&&) = default;
-	
+
 	template<Integer T>
-	constexpr BigInteger(T value) : BigNumber() {
-		if (value < 0) {
-			this->state().is_negative = 1;
+	constexpr BigInteger& operator-=(T value) {
+		Scalar<T> scalar(value);
+		if (scalar.is_limb()) {
+			this->add_limb(scalar.limbs[0], !scalar.negative);
+		} else {
+			this->add_in_place(scalar.view(), true);
 		}
-		this->integer_storage().push_back(static_cast<unit_type>(std::abs(static_cast<int64_t>(value))));
-		this->binary_storage().push_back(value);
+		return *this;
 	}
-	
-	[[nodiscard]] static constexpr BigInteger abs(const BigInteger& number) {
-		BigInteger abs_number = number;
-		abs_number.state().is_negative = 0;
-		return abs_number;
-	} 
 
-	constexpr BigInteger operator+(const BigInteger& other) const {
-		BigInteger result;
-		unit_type num1, num2, res;
-		uint64_t index1, index2, res_index;
-		
-		bool is_one_negative = (this->state().is_negative && !other.state().is_negative) ||
-							   (!this->state().is_negative && other.state().is_negative);
-		result.state().is_negative = (this->state().is_negative && BigInteger::abs(*this) > BigInteger::abs(other)) ||
-									 (other.state().is_negative && BigInteger::abs(*this) < BigInteger::abs(other)) ||
-									 (this->state().is_negative && other.state().is_negative);
-				
-		index1 = this->integer_storage().size();
-		index2 = other.integer_storage().size();
-		res_index = std::max(this->integer_storage().size(), other.integer_storage().size()) + 1;
-		result.integer_storage() = std::vector<unit_type>(res_index);
-		
-		do {
-            index1 -= 1;
-            index2 -= 1;
-            res_index -= 1;
-			if (is_one_negative) {
-				num1 = BigInteger::abs(other) >= BigInteger::abs(*this) ? other.integer_storage().at(index2) : this->integer_storage().at(index1);
-				num2 = BigInteger::abs(other) >= BigInteger::abs(*this) ? this->integer_storage().at(index1) : other.integer_storage().at(index2);
-				res = num1 < num2 ? overflow_unit_of_storage + num1 - num2 : num1 - num2;
-				result.integer_storage().at(res_index) = res - result.integer_storage().at(res_index);
-				result.integer_storage().at(res_index - 1) += (num1 < num2 ? 1 : 0);
-			} else {
-				num1 = this->integer_storage().at(index1);
-				num2 = other.integer_storage().at(index2);
-				res = num1 + num2;
-				result.integer_storage().at(res_index) += res % overflow_unit_of_storage;
-				result.integer_storage().at(res_index - 1) += res / overflow_unit_of_storage;
-			}
-		} while (index1 != 0 && index2 != 0);
-		
-		auto add_remaining_digits = [is_one_negative, &result, &res_index](uint64_t index, const std::vector<unit_type>& vec) {
-		    if (index == 0) return;
-			do {
-                index -= 1;
-                res_index -= 1;
-                if (is_one_negative) {
-                    result.integer_storage().at(res_index) = vec[index] - result.integer_storage().at(res_index);
-                } else {
-                    result.integer_storage().at(res_index) += vec[index];
-                }
-			} while (index != 0);
-		};
-		
-		add_remaining_digits(index1, this->integer_storage());
-		add_remaining_digits(index2, other.integer_storage());
+	template<Integer T>
+	constexpr BigInteger& operator*=(T value) {
+		Scalar<T> scalar(value);
+		if (scalar.is_limb()) {
+			this->multiply_limb(scalar.limbs[0], scalar.negative);
+			return *this;
+		}
+		return *this = BigInteger::multiply(this->view(), scalar.view(), Multiplication::mul);
+	}
 
-		while (result.integer_storage().front() == 0 && result.integer_storage().size() > 1) {
-			result.integer_storage().erase(result.integer_storage().begin());
+	template<Integer T>
+	constexpr BigInteger& operator/=(T value) {
+		Scalar<T> scalar(value);
+		if (scalar.is_limb()) {
+			BigInteger::divide_limb(*this, *this, scalar.limbs[0], scalar.negative);
+			return *this;
 		}
-		
-		if (result.integer_storage().front() == 0 && result.integer_storage().size() == 1) {
-			result.state().is_negative = 0;
+		return *this = BigInteger::divmod(this->view(), scalar.view()).first;
+	}
+
+	/* The remainder keeps the sign of the dividend and fits the limbs already there */
+	template<Integer T>
+	constexpr BigInteger& operator%=(T value) {
+		Scalar<T> scalar(value);
+		if (scalar.is_limb()) {
+			unit_type rest = this->remainder_limb(scalar.limbs[0]);
+			this->integer_storage().assign(&rest, &rest + 1);
+			this->normalize();
+			return *this;
 		}
-		
+		return *this = BigInteger::divmod(this->view(), scalar.view()).second;
+	}
+
+	template<Integer T>
+	constexpr BigInteger operator+(T value) const & {
+		BigInteger result(*this, this->integer_storage().size() + Scalar<T>::size + 1);
+		result += value;
 		return result;
 	}
 
-	constexpr BigInteger operator-() const {
-		BigInteger result = *this;
-		result.state().is_negative = !result.state().is_negative;
+	template<Integer T>
+	constexpr BigInteger operator+(T value) && {
+		(*this) += value;
+		return std::move(*this);
+	}
+
+	template<Integer T>
+	constexpr BigInteger operator-(T value) const & {
+		BigInteger result(*this, this->integer_storage().size() + Scalar<T>::size + 1);
+		result -= value;
 		return result;
 	}
-	
-	constexpr bool operator!() const {
-		return (*this) == 0;
+
+	template<Integer T>
+	constexpr BigInteger operator-(T value) && {
+		(*this) -= value;
+		return std::move(*this);
 	}
-	
-	constexpr BigInteger operator-(const BigInteger& other) const {
-		return (*this) + (-other);
-	}
-
-	constexpr BigInteger operator*(const BigInteger& other) const {
-		using next_type = next_integer_type_t<unit_type>;
-
-		std::vector<std::vector<next_type>> parts(other.integer_storage().size(),
-													std::vector<next_type>(this->integer_storage().size()));
-		next_type num1, num2, res, carry;
-		unit_type res_low, res_high;
-		for (uint64_t ii = other.integer_storage().size(); ii > 0; ii--) {
-            uint64_t i = ii - 1;
-			num1 = static_cast<next_type>(other.integer_storage().at(i));
-			carry = 0;
-			for (uint64_t jj = this->integer_storage().size(); jj > 0; jj--) {
-                uint64_t j = jj - 1;
-				num2 = static_cast<next_type>(this->integer_storage().at(j));
-				res = num1 * num2 + carry;
-				carry = res / overflow_unit_of_storage;
-				if (j != 0)
-					res %= overflow_unit_of_storage;
-				parts.at(i).at(j) = res;
-			}
-		}
-		
-		std::vector<BigInteger> partialSums(other.integer_storage().size());
-		BigInteger finalSum;
-		
-		for (uint64_t ii = other.integer_storage().size(); ii > 0; ii--) {
-            uint64_t i = ii - 1;
-			for (uint64_t jj = 0; jj < this->integer_storage().size(); jj++) {
-                uint64_t j = jj;
-				num1 = parts.at(i).at(j);
-				res_high = static_cast<unit_type>(num1 / overflow_unit_of_storage);
-				res_low = static_cast<unit_type>(num1 % overflow_unit_of_storage);
-				if (res_high != 0) {
-					partialSums.at(i).integer_storage().push_back(res_high);
-				}
-				partialSums.at(i).integer_storage().push_back(res_low);
-			}
-		}
-		
-		for (uint64_t i = 0; i < parts.size(); i++) {
-			for (uint64_t j = 1; j < parts.size() - i; j++) {
-					partialSums.at(i).integer_storage().push_back(0);
-			}
-			finalSum += partialSums.at(i);
-		}
-		
-		finalSum.state().is_negative = this->state().is_negative + other.state().is_negative;
-		
-		return finalSum;
+
+	template<Integer T>
+	constexpr BigInteger operator*(T value) const & {
+		BigInteger result(*this, this->integer_storage().size() + Scalar<T>::size);
+		result *= value;
+		return result;
 	}
 
-	constexpr BigInteger operator/(const BigInteger& other) const {
-		if (other == 0) {
-			throw ArithmeticException("Division by 0 is not allowed.");
+	template<Integer T>
+	constexpr BigInteger operator*(T value) && {
+		(*this) *= value;
+		return std::move(*this);
+	}
+
+	/* The quotient is written straight to its own limbs rather than to a copy of the dividend */
+	template<Integer T>
+	constexpr BigInteger operator/(T value) const & {
+		Scalar<T> scalar(value);
+		if (!scalar.is_limb()) {
+			return BigInteger::divmod(this->view(), scalar.view()).first;
 		}
-		
-		BigInteger remainder = BigInteger::abs(*this);
-		BigInteger abs_other = BigInteger::abs(other);
-		BigInteger quotient = 0;
-		BigInteger pwr_two;
-	    BigInteger double_divisor;
-	    BigInteger double_divisor_storage;
 
-		while (remainder >= abs_other) {
-		    pwr_two = 1;
-		    double_divisor = abs_other;
+		BigInteger quotient;
+		BigInteger::divide_limb(quotient, *this, scalar.limbs[0], scalar.negative);
+		return quotient;
+	}
 
-		    while (double_divisor_storage = double_divisor + double_divisor, double_divisor_storage < remainder) {
-		        double_divisor = double_divisor_storage;
-		        pwr_two += pwr_two;
-		    }
+	template<Integer T>
+	constexpr BigInteger operator/(T value) && {
+		(*this) /= value;
+		return std::move(*this);
+	}
 
-		    quotient += pwr_two;
-		    remainder -= double_divisor;
+	template<Integer T>
+	constexpr BigInteger operator%(T value) const {
+		Scalar<T> scalar(value);
+		if (!scalar.is_limb()) {
+			return BigInteger::divmod(this->view(), scalar.view()).second;
 		}
-		
-		quotient.state().is_negative = this->state().is_negative + other.state().is_negative;
 
-		return quotient;
+		BigInteger remainder = this->remainder_limb(scalar.limbs[0]);
+		remainder.state().is_negative = this->state().is_negative;
+		remainder.normalize();
+		return remainder;
 	}
 
-	constexpr BigInteger operator%(const BigInteger& other) const {
-		BigInteger quotient = (*this) / other;
-		return (*this) - quotient * other;
+	template<Integer T>
+	friend constexpr BigInteger operator+(T value, const BigInteger& number) {
+		return number + value;
 	}
-	
-	constexpr BigInteger operator<<(const BigInteger& other) const {
-		return (*this) * pow(2, other);
+
+	template<Integer T>
+	friend constexpr BigInteger operator+(T value, BigInteger&& number) {
+		return std::move(number) + value;
 	}
-	
-	constexpr BigInteger operator>>(const BigInteger& other) const {
-		return (*this) / pow(2, other);
+
+	template<Integer T>
+	friend constexpr BigInteger operator-(T value, const BigInteger& number) {
+		return -(number - value);
 	}
-	
-	constexpr BigInteger operator&(const BigInteger& other) const {
-		auto this_bin = BigInteger::dec2bin(*this);
-		auto other_bin = BigInteger::dec2bin(other);
 
-		uint64_t index1, index2, res_index;
-		
-		index1 = this_bin.size();
-		index2 = other_bin.size();
-		res_index = std::min(this_bin.size(), other_bin.size());
-		auto result = std::vector<unit_type>(res_index);
-
-		do {
-			index1 -= 1;
-			index2 -= 1;
-			res_index -= 1;
-            result[res_index] = this_bin[index1] & other_bin[index2];
-		} while (index1 != 0 && index2 != 0);
-		
-		return BigInteger::bin2dec(result);
+	template<Integer T>
+	friend constexpr BigInteger operator-(T value, BigInteger&& number) {
+		return -(std::move(number) - value);
 	}
-	
-	constexpr BigInteger operator|(const BigInteger& other) const {
-		auto this_bin = BigInteger::dec2bin(*this);
-		auto other_bin = BigInteger::dec2bin(other);
 
-		uint64_t index1, index2, res_index;
-		
-		index1 = this_bin.size();
-		index2 = other_bin.size();
-		res_index = std::max(this_bin.size(), other_bin.size());
-		auto result = std::vector<unit_type>(res_index);
-
-        do {
-            index1 -= 1;
-            index2 -= 1;
-            res_index -= 1;
-            result[res_index] = this_bin[index1] | other_bin[index2];
-        } while (index1 != 0 && index2 != 0);
-		
-		auto add_remaining_digits = [&result, &res_index](uint64_t index, const std::vector<unit_type>& vec) {
-		    if (index == 0) return;
-			do {
-				index -= 1;
-				res_index -= 1;
-                result.at(res_index) = vec[index];
-			} while (index != 0);
-		};
+	template<Integer T>
+	friend constexpr BigInteger operator*(T value, const BigInteger& number) {
+		return number * value;
+	}
 
-		add_remaining_digits(index1, this_bin);
-		add_remaining_digits(index2, other_bin);
-		
-		return BigInteger::bin2dec(result);
+	template<Integer T>
+	friend constexpr BigInteger operator*(T value, BigInteger&& number) {
+		return std::move(number) * value;
 	}
-	
-	constexpr BigInteger operator^(const BigInteger& other) const {
-        auto this_bin = BigInteger::dec2bin(*this);
-        auto other_bin = BigInteger::dec2bin(other);
-
-        uint64_t index1, index2, res_index;
-
-        index1 = this_bin.size();
-        index2 = other_bin.size();
-        res_index = std::max(this_bin.size(), other_bin.size());
-        auto result = std::vector<unit_type>(res_index);
-
-        do {
-            index1 -= 1;
-            index2 -= 1;
-            res_index -= 1;
-            result[res_index] = this_bin[index1] ^ other_bin[index2];
-        } while (index1 != 0 && index2 != 0);
-
-        auto add_remaining_digits = [&result, &res_index](uint64_t index, const std::vector<unit_type>& vec) {
-            if (index == 0) return;
-            do {
-                index -= 1;
-                res_index -= 1;
-                result.at(res_index) = vec[index];
-            } while (index != 0);
-        };
-
-        add_remaining_digits(index1, this_bin);
-        add_remaining_digits(index2, other_bin);
-
-        return BigInteger::bin2dec(result);
+
+	template<Integer T>
+	friend constexpr BigInteger operator/(T value, const BigInteger& number) {
+		return BigInteger(value) / number;
+	}
+
+	template<Integer T>
+	friend constexpr BigInteger operator%(T value, const BigInteger& number) {
+		return BigInteger(value) % number;
 	}
 	
-	constexpr BigInteger operator~() const {
-		auto this_bin = BigInteger::dec2bin(*this);
+	/* base^exponent by windowed square and multiply, the factors of two of the base are applied as one shift */
+	template<Integer T>
+	[[nodiscard]] static constexpr BigInteger pow(const BigInteger& base, T exponent) {
+		uint64_t value = BigInteger::exponent_value(exponent);
+		if (value == 0) {
+			return 1;
+		}
 
-		uint64_t index;
-		
-		index = this_bin.size();
-		auto result = std::vector<unit_type>(index);
+		if (!base) {
+			return 0;
+		}
 
-		do {
-            index -= 1;
-			result[index] = ~this_bin[index];
-		} while (index != 0);
-		
-		return BigInteger::bin2dec(result);
-	}
+		uint64_t zeros = base.trailing_zeros();
+		BigInteger result = zeros + 1 == base.significant_bits() ? BigInteger(1) : BigInteger::power(base >> zeros, value);
+		if (zeros != 0) {
+			if (zeros > std::numeric_limits<uint64_t>::max() / value) {
+				throw ArithmeticException("Power is too large.");
+			}
+			result.shift_left(zeros * value);
+		}
 
-	constexpr BigInteger& operator++() {
-		(*this) += 1;
-		return *this;
+		result.state().is_negative = base.state().is_negative && (value & 1U) != 0;
+		return result;
 	}
 
+	/* Exponents past 64 bits only fit bases of magnitude at most one */
+	[[nodiscard]] static constexpr BigInteger pow(const BigInteger& base, const BigInteger& exponent) {
+		if (exponent.state().is_negative) {
+			throw ArithmeticException("Exponent must be non negative.");
+		}
 
-	constexpr BigInteger& operator--() {
-		(*this) -= 1;
-		return *this;
+		const auto& limbs = exponent.integer_storage();
+		if (limbs.size() <= 1) {
+			return BigInteger::pow(base, limbs.empty() ? uint64_t(0) : limbs.front());
+		}
+
+		if (base.significant_bits() > 1) {
+			throw ArithmeticException("Power is too large.");
+		}
+		return base.state().is_negative && (limbs.front() & 1U) != 0 ? -base : BigInteger::abs(base);
 	}
 
-	constexpr BigInteger operator++(int32_t) {
-		BigInteger copy = *this;
-		(*this) += 1;
-		return copy;
+	/* Integer square root, rounded down */
+	[[nodiscard]] static constexpr BigInteger isqrt(const BigInteger& number) {
+		return BigInteger::iroot(number, 2);
 	}
 
-	constexpr BigInteger operator--(int32_t) {
-		BigInteger copy = *this;
-		(*this) -= 1;
-		return copy;
+	/* Integer k-th root rounded towards zero, negative numbers only have odd roots */
+	template<Integer T>
+	[[nodiscard]] static constexpr BigInteger iroot(const BigInteger& number, T k) {
+		if (k < 1) {
+			throw ArithmeticException("Root degree must be positive.");
+		}
+
+		auto degree = static_cast<uint64_t>(k);
+		if (number.state().is_negative) {
+			if (degree % 2 == 0) {
+				throw ArithmeticException("Even root of a negative number.");
+			}
+			return -BigInteger::root(-number, degree);
+		}
+
+		if (!number || degree == 1) {
+			return number;
+		}
+		return BigInteger::root(number, degree);
 	}
-	
-	constexpr bool operator==(const BigInteger& other) const {
-		if (this->integer_storage().size() != other.integer_storage().size()) {
-			return false;
+
+	/* Whether number is a^b for integers a and b >= 2, which includes 0, 1 and -1 */
+	[[nodiscard]] static constexpr bool is_perfect_power(const BigInteger& number) {
+		if (number.significant_bits() <= 1) {
+			return true;
 		}
-		
-		if (this->state().is_negative == !other.state().is_negative) {
-			return false;
+
+		/* a^b is a power of every prime dividing b and the exponent of an even a divides the trailing zero bits */
+		uint64_t zeros = number.trailing_zeros();
+		BigInteger odd = BigInteger::abs(number) >> zeros;
+		uint64_t bits = odd.significant_bits();
+		if (!number.state().is_negative && zeros % 2 == 0 && BigInteger::is_odd_square(odd)) {
+			return true;
 		}
-		
-		for (uint64_t i = 0; i < this->integer_storage().size(); i++) {
-			if (this->integer_storage().at(i) != other.integer_storage().at(i)) {
-				return false;
+
+		/* The residue modulo the largest 64 bit prime cheaply rejects almost every candidate root */
+		constexpr unit_type prime = 18446744073709551557ULL;
+		auto residue = [](const BigInteger& value) {
+			BigInteger rest = value % prime;
+			return rest.integer_storage().empty() ? unit_type(0) : rest.integer_storage().front();
+		};
+		auto residue_power = [](unit_type base, uint64_t exponent) {
+			unit_type result = 1;
+			for (; exponent != 0; exponent >>= 1) {
+				if ((exponent & 1U) != 0) {
+					result = static_cast<unit_type>(static_cast<__uint128_t>(result) * base % prime);
+				}
+				base = static_cast<unit_type>(static_cast<__uint128_t>(base) * base % prime);
+			}
+			return result;
+		};
+		unit_type odd_residue = residue(odd);
+
+		for (uint64_t k = 3; k <= std::max(bits, zeros); k += 2) {
+			bool prime_exponent = true;
+			for (uint64_t d = 3; d * d <= k && prime_exponent; d += 2) {
+				prime_exponent = k % d != 0;
+			}
+
+			if (!prime_exponent || zeros % k != 0) {
+				continue;
+			}
+
+			BigInteger root = BigInteger::odd_root_candidate(odd, k, bits);
+			if ((root.significant_bits() - 1) * k >= bits) {
+				continue;
+			}
+			if (residue_power(residue(root), k) == odd_residue && BigInteger::pow(root, k) == odd) {
+				return true;
 			}
 		}
-		
-		return true;
+		return false;
+	}
+	
+	/* Non negative greatest common divisor, gcd(0, 0) is 0 */
+	[[nodiscard]] static constexpr BigInteger gcd(const BigInteger& first, const BigInteger& second) {
+		const auto& a = first.integer_storage();
+		const auto& b = second.integer_storage();
+		if (a.size() <= 1 && b.size() <= 1) {
+			return GreatestCommonDivisor::gcd_1(a.empty() ? 0 : a.front(), b.empty() ? 0 : b.front());
+		}
+		return BigInteger::gcd_magnitudes(BigInteger::abs(first), BigInteger::abs(second), nullptr);
 	}
 
-	constexpr std::strong_ordering operator<=>(const BigInteger& other) const {
-		if (this->state().is_negative == 1 && other.state().is_negative == 0) {
-			return std::strong_ordering::less;
+	/* Non negative least common multiple, 0 when either number is 0 */
+	[[nodiscard]] static constexpr BigInteger lcm(const BigInteger& first, const BigInteger& second) {
+		if (!first || !second) {
+			return 0;
 		}
-		
-		if (this->state().is_negative == 0 && other.state().is_negative == 1) {
-			return std::strong_ordering::greater;
+
+		BigInteger result = BigInteger::abs(first) / BigInteger::gcd(first, second);
+		result *= second;
+		result.state().is_negative = 0;
+		return result;
+	}
+
+	/* (g, s, t) with s * first + t * second = g = gcd(first, second) and |s| <= |second| / 2g when second is not 0 */
+	[[nodiscard]] static constexpr std::tuple<BigInteger, BigInteger, BigInteger> gcdext(const BigInteger& first, const BigInteger& second) {
+		if (!first && !second) {
+			return {BigInteger(), BigInteger(), BigInteger()};
 		}
-	
-		uint64_t counter = 0;
-		unit_type first, second;
-		auto so1 = this->state().is_negative && other.state().is_negative ? std::strong_ordering::greater :
-																			std::strong_ordering::less;
-		auto so2 = this->state().is_negative && other.state().is_negative ? std::strong_ordering::less :
-																			std::strong_ordering::greater;
-		
-		if (this->integer_storage().size() == other.integer_storage().size()) {
-			do {
-				first = *std::next(this->integer_storage().begin(), static_cast<int64_t>(counter));
-				second = *std::next(other.integer_storage().begin(), static_cast<int64_t>(counter));
-				counter += 1;
-			} while (counter != this->integer_storage().size() && first == second);
-			
-			return counter == this->integer_storage().size() && first == second ? std::strong_ordering::equal :
-				   first < second ? so1 : so2;
+
+		BigInteger s;
+		BigInteger g = BigInteger::gcd_magnitudes(BigInteger::abs(first), BigInteger::abs(second), &s);
+		if (first.state().is_negative) {
+			s = -std::move(s);
 		}
-		
-		return this->integer_storage().size() == other.integer_storage().size() ? std::strong_ordering::equal :
-				   this->integer_storage().size() < other.integer_storage().size() ? so1 : so2;
+
+		if (!second) {
+			return {std::move(g), std::move(s), BigInteger()};
+		}
+
+		BigInteger bound = BigInteger::abs(second) / g;
+		s %= bound;
+		if ((BigInteger::abs(s) << 1) > bound) {
+			s += s.state().is_negative ? bound : -bound;
+		}
+
+		BigInteger t = (g - s * first) / second;
+		return {std::move(g), std::move(s), std::move(t)};
 	}
-	
-	static constexpr BigInteger pow(const BigInteger& base, const BigInteger& exponent) {
-		if (exponent == 0) {
-		    return 1;
+
+	/* Inverse of number modulo |modulus| in [0, |modulus|), throws when they share a factor */
+	[[nodiscard]] static constexpr BigInteger modinv(const BigInteger& number, const BigInteger& modulus) {
+		if (!modulus) {
+			throw ArithmeticException("Division by 0 is not allowed.");
 		}
-		
-		if (exponent.integer_storage().back() & 1U) {
-		    return base * pow(base, exponent / 2) * pow(base, exponent / 2);
+
+		BigInteger magnitude = BigInteger::abs(modulus);
+		BigInteger residue = number % magnitude;
+		if (residue.state().is_negative) {
+			residue += magnitude;
 		}
-		
-		return pow(base, exponent / 2) * pow(base, exponent / 2);
+
+		BigInteger inverse;
+		if (BigInteger::gcd_magnitudes(std::move(residue), magnitude, &inverse) != 1) {
+			throw ArithmeticException("Number is not invertible modulo the modulus.");
+		}
+
+		inverse %= magnitude;
+		if (inverse.state().is_negative) {
+			inverse += magnitude;
+		}
+		return inverse;
 	}
-	
-	static constexpr std::vector<unit_type> dec2bin(const BigInteger& number) {
-		std::vector<unit_type> result;
-		BigInteger copy = BigInteger::abs(number);
-		unit_type binary = 0;
-		uint64_t index = 0;
-		
-		while (copy != 0) {
-			binary |= (copy.integer_storage().back() % 2) << index;
-			copy = BigInteger::divide_by_2(copy);
-			index += 1;
-			
-			if (copy == 0 || index == CHAR_BIT * sizeof(unit_type)) {
-				result.push_back(binary);
-				binary = 0;
-				index = 0;
+
+	/*
+	 * The bit queries read the infinite two's complement form that the bitwise operators and dec2bin use, where bit i of
+	 * a negative number is bit i of ~(|number| - 1) and every bit above the magnitude is set.
+	 */
+
+	/* Bits of the shortest two's complement form without its sign bit, so -2^k takes k bits and 2^k takes k + 1 */
+	[[nodiscard]] constexpr uint64_t bit_length() const {
+		uint64_t bits = this->significant_bits();
+		const auto& limbs = this->integer_storage();
+		if (this->state().is_negative && std::has_single_bit(limbs.back()) && this->lowest_limb() + 1 == limbs.size()) {
+			return bits - 1;
+		}
+		return bits;
+	}
+
+	/* Set bits of a non negative number, and the clear bits below the endless run of sign bits of a negative one */
+	[[nodiscard]] constexpr uint64_t popcount() const {
+		const auto& limbs = this->integer_storage();
+		uint64_t count = LimbKernels::popcount(limbs.data(), limbs.size());
+		if (!this->state().is_negative) {
+			return count;
+		}
+
+		/* |number| - 1 clears the lowest set bit of the magnitude and sets the zeros below it */
+		return count - 1 + this->trailing_zeros();
+	}
+
+	/* Zero bits below the lowest set bit, the same for a number and its negation, the maximum of uint64_t for 0 */
+	[[nodiscard]] constexpr uint64_t countr_zero() const {
+		return this->integer_storage().empty() ? std::numeric_limits<uint64_t>::max() : this->trailing_zeros();
+	}
+
+	[[nodiscard]] constexpr bool test_bit(uint64_t bit) const {
+		const auto& limbs = this->integer_storage();
+		uint64_t units = bit / LimbKernels::unit_bits;
+		uint64_t lowest = 0;
+		if (this->state().is_negative) {
+			if (units >= limbs.size()) {
+				return true;
 			}
+			lowest = this->lowest_limb();
 		}
-		
-		std::reverse(result.begin(), result.end());
+		return ((this->twos_complement_limb(units, lowest) >> (bit % LimbKernels::unit_bits)) & 1U) != 0;
+	}
+
+	/* Setting a clear bit adds 2^bit, which takes it off the magnitude of a negative number */
+	constexpr void set_bit(uint64_t bit) {
+		if (!this->test_bit(bit)) {
+			this->add_magnitude_bit(bit, this->state().is_negative);
+		}
+	}
+
+	/* Clearing a set bit subtracts 2^bit, which adds it to the magnitude of a negative number */
+	constexpr void clear_bit(uint64_t bit) {
+		if (this->test_bit(bit)) {
+			this->add_magnitude_bit(bit, !this->state().is_negative);
+		}
+	}
+
+	/* Bits low to high - 1 as a non negative number, those of a negative number above its magnitude are all set */
+	[[nodiscard]] constexpr BigInteger extract_bits(uint64_t low, uint64_t high) const {
+		if (high < low) {
+			throw ArithmeticException("Bit range must not end before it starts.");
+		}
+
+		const auto& limbs = this->integer_storage();
+		uint64_t units = low / LimbKernels::unit_bits;
+		uint64_t shift = low % LimbKernels::unit_bits;
+		uint64_t width = high - low;
+		uint64_t n = (width + LimbKernels::unit_bits - 1) / LimbKernels::unit_bits;
+		uint64_t lowest = 0;
+		if (this->state().is_negative) {
+			lowest = this->lowest_limb();
+		} else {
+			n = std::min(n, limbs.size() > units ? limbs.size() - units : 0);
+		}
+
+		BigInteger result;
+		auto& bits = result.integer_storage();
+		bits.resize(n);
+		unit_type* r = bits.data();
+		for (uint64_t i = 0; i < n; i++) {
+			r[i] = this->twos_complement_limb(units + i, lowest) >> shift;
+			if (shift != 0) {
+				r[i] |= this->twos_complement_limb(units + i + 1, lowest) << (LimbKernels::unit_bits - shift);
+			}
+		}
+
+		if (n * LimbKernels::unit_bits > width) {
+			r[n - 1] &= (unit_type(1) << (width % LimbKernels::unit_bits)) - 1;
+		}
+		result.normalize();
+		return result;
+	}
+
+	/* Most significant unit first, negative numbers in two's complement over the width of their magnitude */
+	static constexpr std::vector<unit_type> dec2bin(const BigInteger& number) {
+		BIGNUMBER_INSTRUMENT(convert, number.integer_storage().size());
+		std::vector<unit_type> result(number.integer_storage().rbegin(), number.integer_storage().rend());
 		
 		if (number.state().is_negative) {
-			for (auto & unit : result) {
-				unit = ~unit;
+			unit_type carry = 1;
+			for (auto unit = result.rbegin(); unit != result.rend(); unit++) {
+				*unit = ~*unit + carry;
+				carry = carry && *unit == 0;
 			}
-
-			result.back() += 1;
 		}
 
 		return result;
@@ -497,38 +2080,16 @@ public:
 		std::cout << '\n';
 	}
 	
+	/* Most significant unit first, read as an unsigned number */
 	static constexpr BigInteger bin2dec(const std::vector<unit_type>& binary) {
-		BigInteger result = 0;
-		uint64_t bit_index = CHAR_BIT * sizeof(unit_type) * binary.size();
-		uint64_t unit_index = CHAR_BIT * sizeof(unit_type);
-		uint64_t index = 0;
-		
-		do {
-            unit_index -= 1;
-            bit_index -= 1;
-
-			if ((binary.at(index) >> unit_index) & 1U) {
-				result += BigInteger::pow(2, bit_index);
-			}
-			
-			if (unit_index == 0) {
-				unit_index = CHAR_BIT * sizeof(unit_type);
-				index += 1;
-			}
-		} while (bit_index != 0);
-		
+		BIGNUMBER_INSTRUMENT(convert, binary.size());
+		BigInteger result;
+		result.integer_storage().assign(binary.rbegin(), binary.rend());
+		result.normalize();
 		return result;
 	}
 
-	DECLARE_ASSIGNMENT_OPERATOR(+)
-	DECLARE_ASSIGNMENT_OPERATOR(-)
-	DECLARE_ASSIGNMENT_OPERATOR(*)
 	DECLARE_ASSIGNMENT_OPERATOR(/)
 	DECLARE_ASSIGNMENT_OPERATOR(%)
-	DECLARE_ASSIGNMENT_OPERATOR(>>)
-	DECLARE_ASSIGNMENT_OPERATOR(<<)
-	DECLARE_ASSIGNMENT_OPERATOR(&)
-	DECLARE_ASSIGNMENT_OPERATOR(|)
-	DECLARE_ASSIGNMENT_OPERATOR(^)
 };
 
@@ -0,0 +1,310 @@
+#pragma once
+
+#include <span>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <utility>
+#include <execution>
+
+#include <ArithmeticException.hpp>
+#include <BigInteger.hpp>
+#include <LimbKernels.hpp>
+#include <LimbAllocator.hpp>
+#include <RadixConversion.hpp>
+#include <ThreadPool.hpp>
+
+/*
+ * Column of numbers with all magnitudes in one limb buffer. Element i takes sizes_[i] limbs from offsets_[i] on, with
+ * its sign kept apart, so elementwise kernels walk flat arrays instead of one heap block per number. A kernel reserves
+ * the largest size its result can take, which leaves at most one unused limb behind an element.
+ */
+class BigIntegerArray {
+public:
+	using unit_type = LimbKernels::unit_type;
+
+private:
+
+	/* Elements handed to one task by the parallel kernels */
+	static constexpr uint64_t parallel_grain = 4096;
+
+	limb_vector limbs_;
+	std::vector<uint64_t> offsets_;
+	std::vector<uint64_t> sizes_;
+	std::vector<uint8_t> negative_;
+
+	/* Calls function(i) for every element, spread over the pool when there is one */
+	template<typename Function>
+	static void for_each(ThreadPool* pool, uint64_t count, const Function& function) {
+		auto body = [&function](uint64_t begin, uint64_t end) {
+			for (uint64_t i = begin; i < end; i++) {
+				function(i);
+			}
+		};
+
+		if (pool == nullptr) {
+			body(0, count);
+		} else {
+			pool->for_each(0, count, parallel_grain, body);
+		}
+	}
+
+	/* Array of count zeros where element i has room for bound(i) limbs */
+	template<typename Bound>
+	static BigIntegerArray layout(uint64_t count, const Bound& bound) {
+		BigIntegerArray result;
+		result.offsets_.resize(count);
+		result.sizes_.assign(count, 0);
+		result.negative_.assign(count, 0);
+
+		uint64_t total = 0;
+		for (uint64_t i = 0; i < count; i++) {
+			result.offsets_[i] = total;
+			total += bound(i);
+		}
+		result.limbs_.resize(total);
+		return result;
+	}
+
+	static void check_sizes(const BigIntegerArray& first, const BigIntegerArray& second) {
+		if (first.size() != second.size()) {
+			throw ArithmeticException("Arrays must have the same size.");
+		}
+	}
+
+	[[nodiscard]] const unit_type* data(uint64_t index) const {
+		return limbs_.data() + offsets_[index];
+	}
+
+	unit_type* data(uint64_t index) {
+		return limbs_.data() + offsets_[index];
+	}
+
+	/* Stores the signed sum of element i of first and of second, with the sign of second flipped for a difference */
+	void add_element(uint64_t i, const BigIntegerArray& first, const BigIntegerArray& second, bool subtract) {
+		const unit_type* x = first.data(i);
+		const unit_type* y = second.data(i);
+		uint64_t xn = first.sizes_[i];
+		uint64_t yn = second.sizes_[i];
+		bool x_negative = first.negative_[i] != 0;
+		bool y_negative = (second.negative_[i] != 0) != subtract && yn != 0;
+		if (xn < yn) {
+			std::swap(x, y);
+			std::swap(xn, yn);
+			std::swap(x_negative, y_negative);
+		}
+
+		unit_type* r = this->data(i);
+		if (x_negative == y_negative) {
+			r[xn] = LimbKernels::add(r, x, xn, y, yn);
+			sizes_[i] = LimbKernels::normalized_size(r, xn + 1);
+			negative_[i] = x_negative;
+			return;
+		}
+
+		int32_t comparison = LimbKernels::compare(x, xn, y, yn);
+		if (comparison < 0) {
+			/* Only possible with equal sizes */
+			std::swap(x, y);
+			x_negative = y_negative;
+		}
+		LimbKernels::sub(r, x, xn, y, yn);
+		sizes_[i] = LimbKernels::normalized_size(r, xn);
+		negative_[i] = x_negative && sizes_[i] != 0;
+	}
+
+	static BigIntegerArray add_arrays(const BigIntegerArray& first, const BigIntegerArray& second, bool subtract,
+									  ThreadPool* pool) {
+		BigIntegerArray::check_sizes(first, second);
+		BigIntegerArray result = BigIntegerArray::layout(first.size(), [&](uint64_t i) {
+			return std::max(first.sizes_[i], second.sizes_[i]) + 1;
+		});
+		BigIntegerArray::for_each(pool, first.size(), [&](uint64_t i) {
+			result.add_element(i, first, second, subtract);
+		});
+		return result;
+	}
+
+	template<typename Factor>
+	static BigIntegerArray multiply_scalars(const BigIntegerArray& numbers, const Factor& factor, ThreadPool* pool) {
+		BigIntegerArray result = BigIntegerArray::layout(numbers.size(), [&](uint64_t i) {
+			return numbers.sizes_[i] + 1;
+		});
+		BigIntegerArray::for_each(pool, numbers.size(), [&](uint64_t i) {
+			int64_t value = factor(i);
+			uint64_t n = numbers.sizes_[i];
+			unit_type* r = result.data(i);
+			unit_type magnitude = value < 0 ? 0 - static_cast<unit_type>(value) : static_cast<unit_type>(value);
+			r[n] = LimbKernels::mul_1(r, numbers.data(i), n, magnitude);
+			result.sizes_[i] = LimbKernels::normalized_size(r, n + 1);
+			result.negative_[i] = result.sizes_[i] != 0 && ((numbers.negative_[i] != 0) != (value < 0));
+		});
+		return result;
+	}
+
+	static int32_t compare_element(const unit_type* x, uint64_t xn, bool x_negative, const unit_type* y, uint64_t yn,
+								   bool y_negative) {
+		if (x_negative != y_negative) {
+			return x_negative ? -1 : 1;
+		}
+
+		int32_t comparison = LimbKernels::compare(x, xn, y, yn);
+		return x_negative ? -comparison : comparison;
+	}
+
+public:
+
+	BigIntegerArray() = default;
+
+	explicit BigIntegerArray(std::span<const BigInteger> numbers) {
+		uint64_t total = 0;
+		for (const BigInteger& number : numbers) {
+			total += number.integer_storage().size();
+		}
+
+		this->reserve(numbers.size(), total);
+		for (const BigInteger& number : numbers) {
+			this->push_back(number);
+		}
+	}
+
+	void reserve(uint64_t count, uint64_t limbs) {
+		limbs_.reserve(limbs);
+		offsets_.reserve(count);
+		sizes_.reserve(count);
+		negative_.reserve(count);
+	}
+
+	void push_back(const BigInteger& number) {
+		const auto& limbs = number.integer_storage();
+		offsets_.push_back(limbs_.size());
+		sizes_.push_back(limbs.size());
+		negative_.push_back(number.state().is_negative);
+		limbs_.insert(limbs_.end(), limbs.begin(), limbs.end());
+	}
+
+	void clear() {
+		limbs_.clear();
+		offsets_.clear();
+		sizes_.clear();
+		negative_.clear();
+	}
+
+	[[nodiscard]] uint64_t size() const {
+		return offsets_.size();
+	}
+
+	[[nodiscard]] bool empty() const {
+		return offsets_.empty();
+	}
+
+	/* Magnitude of an element, least significant limb first and empty for zero */
+	[[nodiscard]] std::span<const unit_type> limbs(uint64_t index) const {
+		return {this->data(index), sizes_[index]};
+	}
+
+	[[nodiscard]] bool is_negative(uint64_t index) const {
+		return negative_[index] != 0;
+	}
+
+	/* Copy of an element */
+	[[nodiscard]] BigInteger operator[](uint64_t index) const {
+		BigInteger number;
+		number.integer_storage().assign(this->data(index), this->data(index) + sizes_[index]);
+		number.state().is_negative = negative_[index] != 0;
+		return number;
+	}
+
+	[[nodiscard]] std::vector<BigInteger> to_vector() const {
+		std::vector<BigInteger> numbers;
+		numbers.reserve(this->size());
+		for (uint64_t i = 0; i < this->size(); i++) {
+			numbers.push_back((*this)[i]);
+		}
+		return numbers;
+	}
+
+	/*
+	 * The kernels below work elementwise and take an execution policy or a ThreadPool as their last argument, the
+	 * parallel policies run on ThreadPool::global(). Arrays combined elementwise must have the same size.
+	 */
+
+	template<typename Execution = const std::execution::sequenced_policy&>
+	[[nodiscard]] static BigIntegerArray add(const BigIntegerArray& first, const BigIntegerArray& second,
+											 Execution&& execution = std::execution::seq) {
+		return BigIntegerArray::add_arrays(first, second, false, ThreadPool::executor(execution));
+	}
+
+	template<typename Execution = const std::execution::sequenced_policy&>
+	[[nodiscard]] static BigIntegerArray sub(const BigIntegerArray& first, const BigIntegerArray& second,
+											 Execution&& execution = std::execution::seq) {
+		return BigIntegerArray::add_arrays(first, second, true, ThreadPool::executor(execution));
+	}
+
+	/* Multiplies every element by the factor of its row */
+	template<typename Execution = const std::execution::sequenced_policy&>
+	[[nodiscard]] static BigIntegerArray mul_scalar(const BigIntegerArray& numbers, std::span<const int64_t> factors,
+													Execution&& execution = std::execution::seq) {
+		if (numbers.size() != factors.size()) {
+			throw ArithmeticException("Every element needs a factor.");
+		}
+		return BigIntegerArray::multiply_scalars(numbers, [factors](uint64_t i) { return factors[i]; },
+												 ThreadPool::executor(execution));
+	}
+
+	template<typename Execution = const std::execution::sequenced_policy&>
+	[[nodiscard]] static BigIntegerArray mul_scalar(const BigIntegerArray& numbers, int64_t factor,
+													Execution&& execution = std::execution::seq) {
+		return BigIntegerArray::multiply_scalars(numbers, [factor](uint64_t) { return factor; },
+												 ThreadPool::executor(execution));
+	}
+
+	/* -1, 0 or 1 as each element of first is below, equal to or above the element of second */
+	template<typename Execution = const std::execution::sequenced_policy&>
+	[[nodiscard]] static std::vector<int32_t> compare(const BigIntegerArray& first, const BigIntegerArray& second,
+													  Execution&& execution = std::execution::seq) {
+		BigIntegerArray::check_sizes(first, second);
+		std::vector<int32_t> result(first.size());
+		BigIntegerArray::for_each(ThreadPool::executor(execution), first.size(), [&](uint64_t i) {
+			result[i] = BigIntegerArray::compare_element(first.data(i), first.sizes_[i], first.negative_[i] != 0,
+														 second.data(i), second.sizes_[i], second.negative_[i] != 0);
+		});
+		return result;
+	}
+
+	/* Compares every element against the same threshold */
+	template<typename Execution = const std::execution::sequenced_policy&>
+	[[nodiscard]] static std::vector<int32_t> compare(const BigIntegerArray& numbers, const BigInteger& threshold,
+													  Execution&& execution = std::execution::seq) {
+		const auto& limbs = threshold.integer_storage();
+		bool negative = threshold.state().is_negative != 0;
+		std::vector<int32_t> result(numbers.size());
+		BigIntegerArray::for_each(ThreadPool::executor(execution), numbers.size(), [&](uint64_t i) {
+			result[i] = BigIntegerArray::compare_element(numbers.data(i), numbers.sizes_[i], numbers.negative_[i] != 0,
+														 limbs.data(), limbs.size(), negative);
+		});
+		return result;
+	}
+
+	/* Decimal representation of every element */
+	template<typename Execution = const std::execution::sequenced_policy&>
+	[[nodiscard]] std::vector<std::string> to_string(Execution&& execution = std::execution::seq) const {
+		std::vector<std::string> result(this->size());
+		BigIntegerArray::for_each(ThreadPool::executor(execution), this->size(), [&](uint64_t i) {
+			uint64_t n = sizes_[i];
+			result[i].resize_and_overwrite(RadixConversion::max_digits(n) + 1, [&](char* first, uint64_t) {
+				char* out = first;
+				if (n == 0) {
+					*out++ = '0';
+				} else {
+					if (negative_[i] != 0) {
+						*out++ = '-';
+					}
+					out = RadixConversion::to_decimal(out, this->data(i), n);
+				}
+				return static_cast<uint64_t>(out - first);
+			});
+		});
+		return result;
+	}
+};
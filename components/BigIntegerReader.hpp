@@ -0,0 +1,143 @@
+#pragma once
+
+#include <array>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+#include <string_view>
+
+#include <BigIntegerView.hpp>
+#include <LimbKernels.hpp>
+#include <LimbAllocator.hpp>
+#include <NumberFormatException.hpp>
+#include <RadixConversion.hpp>
+
+/*
+ * Decimal parser fed the text piece by piece, an optional leading '-' and then digits. Digits are converted a block at
+ * a time and the blocks are joined like a binary counter: two parts of 19 * 2^level digits each become one of the next
+ * level, which keeps the work subquadratic. Only the parts and one block of text are held, so the memory stays near
+ * the binary size of the number however large the text is.
+ */
+class BigIntegerReader {
+public:
+	using unit_type = LimbKernels::unit_type;
+
+private:
+
+	/* Blocks of 19 * 2^5 = 608 digits */
+	static constexpr uint64_t block_level = 5;
+	static constexpr uint64_t block_digits = RadixConversion::level_digits(block_level);
+
+	/* The value of 19 * 2^level digits of the text */
+	struct Part {
+		limb_vector limbs;
+		uint64_t level = 0;
+	};
+
+	std::vector<Part> parts_;
+	std::array<char, block_digits> block_;
+	uint64_t filled_ = 0;
+	uint64_t characters_ = 0;
+	bool negative_ = false;
+	limb_vector result_;
+
+	static limb_vector parse_block(const char* digits, uint64_t length) {
+		limb_vector limbs(length / RadixConversion::digits_per_unit + 1);
+		limbs.resize(RadixConversion::from_decimal(limbs.data(), digits, length));
+		return limbs;
+	}
+
+	static limb_vector combine(const limb_vector& high, const limb_vector& low, uint64_t level) {
+		limb_vector limbs(high.size() + RadixConversion::level_size(level) + 1);
+		limbs.resize(RadixConversion::combine(limbs.data(), high.data(), high.size(), low.data(), low.size(), level));
+		return limbs;
+	}
+
+	void push_block() {
+		parts_.push_back({BigIntegerReader::parse_block(block_.data(), block_digits), block_level});
+		filled_ = 0;
+		while (parts_.size() >= 2 && parts_[parts_.size() - 2].level == parts_.back().level) {
+			Part low = std::move(parts_.back());
+			parts_.pop_back();
+			Part& high = parts_.back();
+			high.limbs = BigIntegerReader::combine(high.limbs, low.limbs, low.level);
+			high.level += 1;
+		}
+	}
+
+public:
+
+	/* Appends the next piece of the text, throws NumberFormatException at a character that cannot continue a number */
+	void feed(std::string_view text) {
+		if (!text.empty() && characters_ == 0 && text.front() == '-') {
+			negative_ = true;
+			text.remove_prefix(1);
+			characters_ = 1;
+		}
+
+		auto invalid = std::find_if(text.begin(), text.end(), [](char digit) { return digit < '0' || digit > '9'; });
+		if (invalid != text.end()) {
+			throw NumberFormatException("containing '" + std::string(1, *invalid) + "'");
+		}
+
+		characters_ += text.size();
+		while (!text.empty()) {
+			uint64_t count = std::min<uint64_t>(text.size(), block_digits - filled_);
+			std::copy_n(text.begin(), count, block_.begin() + static_cast<int64_t>(filled_));
+			filled_ += count;
+			text.remove_prefix(count);
+			if (filled_ == block_digits) {
+				this->push_block();
+			}
+		}
+	}
+
+	/*
+	 * Ends the number and returns a view of it, valid until the reader is fed again, which starts the next number.
+	 * Throws NumberFormatException when no digit was fed.
+	 */
+	[[nodiscard]] BigIntegerView finish() {
+		if (characters_ == static_cast<uint64_t>(negative_)) {
+			throw NumberFormatException(negative_ ? "-" : "");
+		}
+
+		/* The parts shrink from left to right, each joins the digits before it */
+		result_.clear();
+		for (const Part& part : parts_) {
+			result_ = BigIntegerReader::combine(result_, part.limbs, part.level);
+		}
+
+		if (filled_ != 0) {
+			uint64_t n = result_.size();
+			result_.resize(n + filled_ / RadixConversion::digits_per_unit + 2);
+			for (uint64_t digits = filled_; digits != 0;) {
+				uint64_t count = std::min(digits, RadixConversion::digits_per_unit);
+				unit_type scale = 1;
+				for (uint64_t i = 0; i < count; i++) {
+					scale *= 10;
+				}
+				unit_type carry = LimbKernels::mul_1(result_.data(), result_.data(), n, scale);
+				if (carry != 0) {
+					result_[n++] = carry;
+				}
+				digits -= count;
+			}
+
+			limb_vector low = BigIntegerReader::parse_block(block_.data(), filled_);
+			n = std::max(n, low.size());
+			unit_type carry = LimbKernels::add(result_.data(), result_.data(), n, low.data(), low.size());
+			if (carry != 0) {
+				result_[n++] = carry;
+			}
+			result_.resize(LimbKernels::normalized_size(result_.data(), n));
+		}
+
+		bool negative = negative_;
+		parts_.clear();
+		filled_ = 0;
+		characters_ = 0;
+		negative_ = false;
+		return {{result_.data(), result_.size()}, negative};
+	}
+};
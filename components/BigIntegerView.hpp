@@ -0,0 +1,84 @@
+#pragma once
+
+#include <bit>
+#include <span>
+#include <string>
+#include <cstddef>
+#include <cstdint>
+#include <compare>
+
+#include <LimbKernels.hpp>
+#include <NumberFormatException.hpp>
+#include <Serialization.hpp>
+
+/*
+ * Read only number over limbs owned by someone else, such as the fixed encoding in an mmapped file or a network buffer.
+ * Nothing is copied, so the limbs must outlive the view and must not be written while it is in use.
+ */
+class BigIntegerView {
+public:
+	using unit_type = LimbKernels::unit_type;
+
+private:
+	std::span<const unit_type> limbs_;
+	bool negative_ = false;
+
+public:
+
+	constexpr BigIntegerView() = default;
+
+	/* Magnitude least significant limb first, high zero limbs are left out of the view */
+	constexpr BigIntegerView(std::span<const unit_type> limbs, bool negative)
+		: limbs_(limbs.first(LimbKernels::normalized_size(limbs.data(), limbs.size()))),
+		  negative_(negative && !limbs_.empty()) {
+	}
+
+	/*
+	 * View over the fixed encoding at the front of bytes, which needs its limbs aligned to 8 bytes on a little endian
+	 * machine. The compact encoding and other layouts have to go through BigInteger::deserialize.
+	 */
+	[[nodiscard]] static BigIntegerView from_bytes(std::span<const std::byte> bytes) {
+		Serialization::Header header = Serialization::read_header(bytes);
+		const std::byte* limbs = bytes.data() + Serialization::header_size;
+		if (header.format != Serialization::Format::fixed || std::endian::native != std::endian::little ||
+			reinterpret_cast<uintptr_t>(limbs) % alignof(unit_type) != 0) {
+			throw NumberFormatException("of " + std::to_string(bytes.size()) + " bytes");
+		}
+
+		return {{reinterpret_cast<const unit_type*>(limbs), header.limbs}, header.negative};
+	}
+
+	[[nodiscard]] constexpr std::span<const unit_type> limbs() const {
+		return limbs_;
+	}
+
+	[[nodiscard]] constexpr const unit_type* data() const {
+		return limbs_.data();
+	}
+
+	[[nodiscard]] constexpr uint64_t size() const {
+		return limbs_.size();
+	}
+
+	[[nodiscard]] constexpr bool is_negative() const {
+		return negative_;
+	}
+
+	constexpr bool operator!() const {
+		return limbs_.empty();
+	}
+
+	friend constexpr bool operator==(BigIntegerView first, BigIntegerView second) {
+		return first.negative_ == second.negative_ &&
+			   LimbKernels::compare(first.data(), first.size(), second.data(), second.size()) == 0;
+	}
+
+	friend constexpr std::strong_ordering operator<=>(BigIntegerView first, BigIntegerView second) {
+		if (first.negative_ != second.negative_) {
+			return first.negative_ ? std::strong_ordering::less : std::strong_ordering::greater;
+		}
+
+		int32_t comparison = LimbKernels::compare(first.data(), first.size(), second.data(), second.size());
+		return (first.negative_ ? -comparison : comparison) <=> 0;
+	}
+};
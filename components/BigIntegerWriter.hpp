@@ -0,0 +1,56 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <concepts>
+#include <ostream>
+#include <algorithm>
+#include <string_view>
+
+#include <BigIntegerView.hpp>
+#include <RadixConversion.hpp>
+
+/*
+ * Decimal printer that hands the text to a sink in pieces of at most chunk characters, so printing a number never
+ * holds its whole text. Besides the chunk it needs about twice the binary size of the number.
+ */
+class BigIntegerWriter {
+public:
+	static constexpr uint64_t default_chunk = 1 << 16;
+
+private:
+	std::vector<char> buffer_;
+
+public:
+
+	/* Chunks below RadixConversion::min_chunk characters are raised to it */
+	explicit BigIntegerWriter(uint64_t chunk = default_chunk) : buffer_(std::max(chunk, RadixConversion::min_chunk)) {
+	}
+
+	[[nodiscard]] uint64_t chunk() const {
+		return buffer_.size();
+	}
+
+	/* Calls sink(std::string_view) with consecutive pieces of the text, the view is only valid during the call */
+	template<typename Sink> requires std::invocable<Sink&, std::string_view>
+	void write(BigIntegerView number, Sink&& sink) {
+		if (!number) {
+			sink(std::string_view("0"));
+			return;
+		}
+
+		if (number.is_negative()) {
+			sink(std::string_view("-"));
+		}
+		RadixConversion::to_decimal_chunked(buffer_.data(), buffer_.size(), number.data(), number.size(),
+											[&sink](const char* digits, uint64_t count) {
+			sink(std::string_view(digits, count));
+		});
+	}
+
+	void write(BigIntegerView number, std::ostream& os) {
+		this->write(number, [&os](std::string_view digits) {
+			os.write(digits.data(), static_cast<std::streamsize>(digits.size()));
+		});
+	}
+};
@@ -1,16 +1,28 @@
 #pragma once
 
-#include <vector>
+#include <span>
+#include <array>
 #include <string>
+#include <vector>
 #include <cstdint>
-#include <iomanip>
+#include <cstddef>
+#include <charconv>
+#include <utility>
 #include <iostream>
-
+#include <algorithm>
+#include <system_error>
+
+#include <ArithmeticException.hpp>
+#include <LimbKernels.hpp>
+#include <LimbStorage.hpp>
+#include <RadixConversion.hpp>
+#include <Serialization.hpp>
 #include <Traits.hpp>
 
 class BigNumber {
 public:
 	using unit_type = uint64_t;
+	using storage_type = LimbStorage<4>;
 private:
 
 	#pragma GCC diagnostic push
@@ -24,39 +36,11 @@ private:
 	} state_;
 	#pragma GCC diagnostic pop
 	
-	std::vector<unit_type> integer_storage_;
-    [[maybe_unused]] std::vector<unit_type> fractional_storage_;
-    std::vector<unit_type> binary_storage_;
+	/* Base 2^64 limbs, least significant first, no high zero limbs, empty for zero */
+	storage_type integer_storage_;
 
 protected:
 
-    [[maybe_unused]] static constexpr unit_type digits_to_store = static_cast<unit_type>(([]<typename T>(){
-		if constexpr (std::is_same_v<T, uint64_t>) {
-			return 18;
-		}
-
-		if constexpr (std::is_same_v<T, uint32_t>) {
-			return 9;
-		}
-
-		throw std::runtime_error("This unit type is not supported!");
-	}).operator()<unit_type>());
-
-    [[maybe_unused]] static constexpr unit_type overflow_unit_of_storage = static_cast<unit_type>(([]<typename T>(){
-		if constexpr (std::is_same_v<T, uint64_t>) {
-			return 1e18;
-		}
-
-		if constexpr (std::is_same_v<T, uint32_t>) {
-			return 1e9;
-		}
-
-		throw std::runtime_error("This unit type is not supported!");
-	}).operator()<unit_type>());
-
-    [[maybe_unused]] static constexpr unit_type half_overflow_unit_of_storage = overflow_unit_of_storage / 2;
-	[[maybe_unused]] static constexpr unit_type max_unit_of_storage = overflow_unit_of_storage - 1;
-	
 	constexpr explicit BigNumber(const std::string&) {
 		/* Nothing yet */
 	};
@@ -66,36 +50,45 @@ protected:
 	constexpr BigNumber(BigNumber&&) = default;
 	constexpr BigNumber& operator=(const BigNumber&) = default;
 	constexpr BigNumber& operator=(BigNumber&&) = default;
+	constexpr ~BigNumber() = default;
+
+	void parse(const std::string& number) {
+		bool negative = number.front() == '-';
+		uint64_t digits = number.size() - negative;
 
-	void parse(const std::string& number) noexcept {
-		uint64_t len = number.size();
-        uint64_t counter = 0, index;
-        uint64_t start = len % digits_to_store;
-		state_.is_negative = number.front() == '-';
-		if (start - state_.is_negative != 0) {
-			this->integer_storage().push_back(std::stoull(number.substr(state_.is_negative, start - state_.is_negative)));
+		this->integer_storage().resize(digits / RadixConversion::digits_per_unit + 1);
+		this->integer_storage().resize(RadixConversion::from_decimal(this->integer_storage().data(), number.data() + negative, digits));
+		state_.is_negative = negative;
+		this->normalize();
+	}
+
+	/* Writes the sign and digits to out, which must hold max_chars() characters */
+	char* write_decimal(char* out) const {
+		if (this->integer_storage().empty()) {
+			*out++ = '0';
+			return out;
 		}
-		while (counter < len / static_cast<int64_t>(digits_to_store)) {
-			index = start + counter * digits_to_store;
-			this->integer_storage().push_back(std::stoull(number.substr(index, digits_to_store)));
-			counter += 1;
+
+		if (state_.is_negative) {
+			*out++ = '-';
 		}
+		return RadixConversion::to_decimal(out, this->integer_storage().data(), this->integer_storage().size());
 	}
 
-	constexpr std::vector<unit_type>& integer_storage() {
-		return integer_storage_;
+	constexpr void normalize() {
+		auto& limbs = this->integer_storage();
+		limbs.resize(LimbKernels::normalized_size(std::as_const(limbs).data(), limbs.size()));
+		if (limbs.empty()) {
+			state_.is_negative = 0;
+		}
 	}
-	
-	[[nodiscard]] constexpr const std::vector<unit_type>& integer_storage() const {
+
+	constexpr storage_type& integer_storage() {
 		return integer_storage_;
 	}
 	
-	constexpr std::vector<unit_type>& binary_storage() {
-		return binary_storage_;
-	}
-	
-	[[nodiscard]] constexpr const std::vector<unit_type>& binary_storage() const {
-		return binary_storage_;
+	[[nodiscard]] constexpr const storage_type& integer_storage() const {
+		return integer_storage_;
 	}
 	
 	constexpr auto& state() {
@@ -106,25 +99,79 @@ protected:
 		return state_;
 	}
 	
-	virtual void check_number(const std::string& number) const = 0;
-	
 public:
 
-	friend std::ostream& operator<<(std::ostream& os, const BigNumber& number) {
-		if (number.state_.is_negative) {
-			std::cout << '-';
+	/* Characters written to a stream at a time */
+	static constexpr uint64_t stream_chunk = 1 << 16;
+
+	/* Upper bound on the length of the decimal representation, including the sign */
+	[[nodiscard]] constexpr uint64_t max_chars() const {
+		return RadixConversion::max_digits(this->integer_storage().size()) + 1;
+	}
+
+	std::to_chars_result to_chars(char* first, char* last) const {
+		auto capacity = static_cast<uint64_t>(last - first);
+		if (capacity >= this->max_chars()) {
+			return {this->write_decimal(first), std::errc()};
+		}
+
+		std::string digits = this->to_string();
+		if (digits.size() > capacity) {
+			return {last, std::errc::value_too_large};
+		}
+		return {std::copy(digits.begin(), digits.end(), first), std::errc()};
+	}
+
+	[[nodiscard]] std::string to_string() const {
+		std::string digits;
+		digits.resize_and_overwrite(this->max_chars(), [this](char* data, uint64_t) {
+			return static_cast<uint64_t>(this->write_decimal(data) - data);
+		});
+		return digits;
+	}
+
+	[[nodiscard]] uint64_t serialized_size(Serialization::Format format = Serialization::Format::fixed) const {
+		return Serialization::size(this->integer_storage().data(), this->integer_storage().size(), format);
+	}
+
+	/* Writes the binary encoding to the front of out, returns the number of bytes written */
+	uint64_t serialize(std::span<std::byte> out, Serialization::Format format = Serialization::Format::fixed) const {
+		if (out.size() < this->serialized_size(format)) {
+			throw ArithmeticException("The buffer is too small for the encoding.");
 		}
+		return Serialization::write(out.data(), this->integer_storage().data(), this->integer_storage().size(),
+									state_.is_negative != 0, format);
+	}
+
+	[[nodiscard]] std::vector<std::byte> serialize(Serialization::Format format = Serialization::Format::fixed) const {
+		std::vector<std::byte> bytes(this->serialized_size(format));
+		this->serialize(bytes, format);
+		return bytes;
+	}
 
-		for (auto unit : number.integer_storage()) {
-			os << unit;
-			os << std::setfill('0') << std::setw(digits_to_store);
+	friend std::ostream& operator<<(std::ostream& os, const BigNumber& number) {
+		constexpr uint64_t buffer_units = 8;
+		if (number.integer_storage().size() <= buffer_units) {
+			std::array<char, RadixConversion::max_digits(buffer_units) + 1> buffer;
+			char* end = number.write_decimal(buffer.data());
+			return os.write(buffer.data(), end - buffer.data());
 		}
 
-		os << std::setfill(' ') << std::setw(0);
+		if (number.max_chars() <= stream_chunk) {
+			std::string digits = number.to_string();
+			return os.write(digits.data(), static_cast<std::streamsize>(digits.size()));
+		}
 
+		/* Huge numbers go out piece by piece instead of as one string */
+		std::vector<char> buffer(stream_chunk);
+		if (number.state_.is_negative) {
+			os.put('-');
+		}
+		RadixConversion::to_decimal_chunked(buffer.data(), buffer.size(), number.integer_storage().data(),
+											number.integer_storage().size(), [&os](const char* digits, uint64_t count) {
+			os.write(digits, static_cast<std::streamsize>(count));
+		});
 		return os;
 	}
-	
-	virtual ~BigNumber() = default;
 };
 
@@ -0,0 +1,284 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+
+#include <Instrumentation.hpp>
+#include <LimbKernels.hpp>
+#include <LimbAllocator.hpp>
+#include <Multiplication.hpp>
+#include <ThreadPool.hpp>
+
+class Division {
+public:
+	using unit_type = LimbKernels::unit_type;
+	using next_type = LimbKernels::next_type;
+
+	static constexpr uint64_t divide_and_conquer_threshold = 48;
+	static constexpr uint64_t invert_threshold = 32;
+
+private:
+
+	/* Product of two blocks, the kernel expects the longer operand first */
+	static constexpr void mul(unit_type* r, const unit_type* a, uint64_t an, const unit_type* b, uint64_t bn) {
+		if (an >= bn) {
+			Multiplication::mul(r, a, an, b, bn);
+		} else {
+			Multiplication::mul(r, b, bn, a, an);
+		}
+	}
+
+	/* Divides n2:n1:n0 by the normalized d1:d0 with n2:n1 < d1:d0, the remainder goes to r1:r0 */
+	static constexpr unit_type divrem_3by2(unit_type& r1, unit_type& r0, unit_type n2, unit_type n1, unit_type n0,
+										   unit_type d1, unit_type d0, unit_type v) {
+		constexpr uint64_t bits = LimbKernels::unit_bits;
+		next_type estimate = static_cast<next_type>(n2) * v + ((static_cast<next_type>(n2) << bits) | n1);
+		unit_type q = static_cast<unit_type>(estimate >> bits);
+		unit_type q0 = static_cast<unit_type>(estimate);
+		next_type d = (static_cast<next_type>(d1) << bits) | d0;
+		next_type r = ((static_cast<next_type>(n1 - d1 * q) << bits) | n0) - d - static_cast<next_type>(d0) * q;
+
+		q += 1;
+		if (static_cast<unit_type>(r >> bits) >= q0) {
+			q -= 1;
+			r += d;
+		}
+		if (r >= d) {
+			q += 1;
+			r -= d;
+		}
+
+		r1 = static_cast<unit_type>(r >> bits);
+		r0 = static_cast<unit_type>(r);
+		return q;
+	}
+
+	/*
+	 * Schoolbook division (Knuth's algorithm D) with quotient limbs estimated from three numerator limbs.
+	 * Divides np (nn limbs) by the normalized dp (dn >= 2 limbs), writes nn - dn quotient limbs to qp,
+	 * leaves the remainder in the low dn limbs of np and returns the extra high quotient limb.
+	 */
+	static constexpr unit_type divrem_basecase(unit_type* qp, unit_type* np, uint64_t nn, const unit_type* dp, uint64_t dn,
+											   unit_type v) {
+		BIGNUMBER_INSTRUMENT(divide_basecase, nn);
+		unit_type qh = LimbKernels::compare_n(np + nn - dn, dp, dn) >= 0;
+		if (qh != 0) {
+			LimbKernels::sub_n(np + nn - dn, np + nn - dn, dp, dn);
+		}
+
+		unit_type d1 = dp[dn - 1];
+		unit_type d0 = dp[dn - 2];
+		unit_type n1 = np[nn - 1];
+
+		for (uint64_t i = nn - dn; i > 0; i--) {
+			unit_type* window = np + i - 1;
+			unit_type q;
+
+			if (n1 == d1 && window[dn - 1] == d0) {
+				q = ~static_cast<unit_type>(0);
+				LimbKernels::submul_1(window, dp, dn, q);
+				n1 = window[dn - 1];
+			} else {
+				unit_type n0;
+				q = Division::divrem_3by2(n1, n0, n1, window[dn - 1], window[dn - 2], d1, d0, v);
+
+				unit_type borrow = LimbKernels::submul_1(window, dp, dn - 2, q);
+				unit_type borrow1 = n0 < borrow;
+				n0 -= borrow;
+				borrow = n1 < borrow1;
+				n1 -= borrow1;
+				window[dn - 2] = n0;
+
+				if (borrow != 0) {
+					n1 += d1 + LimbKernels::add_n(window, window, dp, dn - 1);
+					q -= 1;
+				}
+			}
+
+			qp[i - 1] = q;
+		}
+
+		np[dn - 1] = n1;
+		return qh;
+	}
+
+	/*
+	 * Recursive division of 2n limbs by n limbs (Burnikel-Ziegler), tp must hold n limbs. The two halves of the quotient
+	 * depend on each other, so a pool only speeds up the products that correct them, at every level of the recursion.
+	 */
+	static constexpr unit_type divrem_dc_n(unit_type* qp, unit_type* np, const unit_type* dp, uint64_t n, unit_type v,
+										   unit_type* tp, ThreadPool* pool) {
+		uint64_t low = n / 2;
+		uint64_t high = n - low;
+		unit_type qh, ql, borrow;
+
+		if (high < divide_and_conquer_threshold) {
+			qh = Division::divrem_basecase(qp + low, np + 2 * low, 2 * high, dp + low, high, v);
+		} else {
+			qh = Division::divrem_dc_n(qp + low, np + 2 * low, dp + low, high, v, tp, pool);
+		}
+
+		borrow = Multiplication::submul(np + low, n, qp + low, high, dp, low, tp, pool);
+		if (qh != 0) {
+			borrow += LimbKernels::sub_n(np + n, np + n, dp, low);
+		}
+		while (borrow != 0) {
+			qh -= LimbKernels::sub_1(qp + low, qp + low, high, 1);
+			borrow -= LimbKernels::add_n(np + low, np + low, dp, n);
+		}
+
+		if (low < divide_and_conquer_threshold) {
+			ql = Division::divrem_basecase(qp, np + high, 2 * low, dp + high, low, v);
+		} else {
+			ql = Division::divrem_dc_n(qp, np + high, dp + high, low, v, tp, pool);
+		}
+
+		borrow = Multiplication::submul(np, n, dp, high, qp, low, tp, pool);
+		if (ql != 0) {
+			borrow += LimbKernels::sub_n(np + low, np + low, dp, high);
+		}
+		while (borrow != 0) {
+			LimbKernels::sub_1(qp, qp, low, 1);
+			borrow -= LimbKernels::add_n(np, np, dp, n);
+		}
+
+		return qh;
+	}
+
+	/* Produces the top qn <= dn quotient limbs, np points past the current partial remainder */
+	static constexpr unit_type divrem_dc_top(unit_type* qp, unit_type* np, uint64_t qn, const unit_type* dp, uint64_t dn,
+											 unit_type v, unit_type* tp, ThreadPool* pool) {
+		if (qn < divide_and_conquer_threshold) {
+			return Division::divrem_basecase(qp, np - dn, dn + qn, dp, dn, v);
+		}
+
+		unit_type qh = Division::divrem_dc_n(qp, np - qn, dp + dn - qn, qn, v, tp, pool);
+		if (qn != dn) {
+			unit_type borrow = Multiplication::submul(np - dn, dn, qp, qn, dp, dn - qn, tp, pool);
+			if (qh != 0) {
+				borrow += LimbKernels::sub_n(np - dn + qn, np - dn + qn, dp, dn - qn);
+			}
+			while (borrow != 0) {
+				qh -= LimbKernels::sub_1(qp, qp, qn, 1);
+				borrow -= LimbKernels::add_n(np - dn, np - dn, dp, dn);
+			}
+		}
+
+		return qh;
+	}
+
+	static constexpr unit_type divrem_dc(unit_type* qp, unit_type* np, uint64_t nn, const unit_type* dp, uint64_t dn,
+										 unit_type v, ThreadPool* pool) {
+		BIGNUMBER_INSTRUMENT(divide_recursive, nn);
+		limb_vector tp(dn);
+		uint64_t qn = nn - dn;
+		uint64_t top = qn % dn == 0 ? dn : qn % dn;
+
+		qp += qn - top;
+		np += nn - top;
+		unit_type qh = Division::divrem_dc_top(qp, np, top, dp, dn, v, tp.data(), pool);
+
+		for (qn -= top; qn != 0; qn -= dn) {
+			qp -= dn;
+			np -= dn;
+			Division::divrem_dc_n(qp, np - dn, dp, dn, v, tp.data(), pool);
+		}
+
+		return qh;
+	}
+
+public:
+
+	/* Reciprocal of the top two limbs d1:d0 of a normalized divisor */
+	static constexpr unit_type reciprocal_3by2(unit_type d1, unit_type d0) {
+		unit_type v = LimbKernels::reciprocal(d1);
+		unit_type p = d1 * v + d0;
+
+		if (p < d0) {
+			v -= 1;
+			if (p >= d1) {
+				v -= 1;
+				p -= d1;
+			}
+			p -= d1;
+		}
+
+		next_type t = static_cast<next_type>(d0) * v;
+		unit_type t1 = static_cast<unit_type>(t >> LimbKernels::unit_bits);
+		unit_type t0 = static_cast<unit_type>(t);
+		p += t1;
+		if (p < t1) {
+			v -= 1;
+			if (p >= d1 && (p > d1 || t0 >= d0)) {
+				v -= 1;
+			}
+		}
+
+		return v;
+	}
+
+	/*
+	 * Approximates floor(B^2n / d) for a normalized d of n >= 2 limbs into the n + 1 limbs of x, off by at most a
+	 * few units in either direction. Newton's iteration x + x * (B^2n - d * x) / B^2n starts from the reciprocal of the
+	 * top h = n / 2 + 1 limbs, which is precise enough for a single step to reach full precision.
+	 */
+	static constexpr void invert(unit_type* x, const unit_type* d, uint64_t n) {
+		if (n <= invert_threshold) {
+			limb_vector numerator(2 * n + 1);
+			numerator.back() = 1;
+			Division::divrem(x, numerator.data(), 2 * n + 1, d, n);
+			return;
+		}
+
+		uint64_t h = n / 2 + 1;
+		limb_vector top(h + 1);
+		Division::invert(top.data(), d + n - h, h);
+
+		/* The residual B^(n + h) - d * top is small, its sign decides the direction of the correction */
+		limb_vector residual(n + h + 1);
+		Division::mul(residual.data(), d, n, top.data(), h + 1);
+		bool negative = residual[n + h] != 0;
+		if (negative) {
+			residual[n + h] -= 1;
+		} else {
+			for (uint64_t i = 0; i < n + h; i++) {
+				residual[i] = ~residual[i];
+			}
+			LimbKernels::add_1(residual.data(), residual.data(), n + h, 1);
+		}
+
+		uint64_t rn = LimbKernels::normalized_size(residual.data(), n + h + 1);
+		uint64_t pn = h + 1 + rn;
+		uint64_t cn = 0;
+		limb_vector correction(pn);
+		if (pn > 2 * h) {
+			Division::mul(correction.data(), top.data(), h + 1, residual.data(), rn);
+			cn = LimbKernels::normalized_size(correction.data() + 2 * h, pn - 2 * h);
+		}
+
+		LimbKernels::zero(x, n - h);
+		LimbKernels::copy(x + n - h, top.data(), h + 1);
+		if (negative) {
+			LimbKernels::sub(x, x, n + 1, correction.data() + 2 * h, cn);
+			LimbKernels::sub_1(x, x, n + 1, 1);
+		} else {
+			LimbKernels::add(x, x, n + 1, correction.data() + 2 * h, cn);
+		}
+	}
+
+	/*
+	 * Divides np (nn limbs) by the normalized dp (2 <= dn <= nn limbs). Writes nn - dn quotient limbs to qp,
+	 * leaves the remainder in the low dn limbs of np and returns the extra high quotient limb. Given a pool, the large
+	 * products of the recursive division spread over it.
+	 */
+	static constexpr unit_type divrem(unit_type* qp, unit_type* np, uint64_t nn, const unit_type* dp, uint64_t dn,
+									  ThreadPool* pool = nullptr) {
+		unit_type v = Division::reciprocal_3by2(dp[dn - 1], dp[dn - 2]);
+
+		if (dn < divide_and_conquer_threshold || nn - dn < divide_and_conquer_threshold) {
+			return Division::divrem_basecase(qp, np, nn, dp, dn, v);
+		}
+
+		return Division::divrem_dc(qp, np, nn, dp, dn, v, pool);
+	}
+};
@@ -0,0 +1,380 @@
+#pragma once
+
+#include <bit>
+#include <climits>
+#include <span>
+#include <array>
+#include <limits>
+#include <cstdint>
+#include <compare>
+#include <ostream>
+#include <utility>
+#include <algorithm>
+#include <type_traits>
+
+#include <ArithmeticException.hpp>
+#include <BigInteger.hpp>
+#include <BigIntegerView.hpp>
+#include <Division.hpp>
+#include <LimbKernels.hpp>
+#include <Traits.hpp>
+
+/*
+ * Integer of Bits bits in limbs on the stack, in two's complement when Signed. Arithmetic wraps modulo 2^Bits like the
+ * built in types do, and every loop runs over a limb count known at compile time, so small widths unroll completely.
+ * Conversions from and to BigInteger are explicit, the one to FixedInteger keeps the value modulo 2^Bits.
+ */
+template<uint64_t Bits, bool Signed = true>
+class FixedInteger {
+public:
+	using unit_type = LimbKernels::unit_type;
+	using next_type = next_integer_type_t<unit_type>;
+
+	static_assert(Bits != 0 && Bits % LimbKernels::unit_bits == 0, "The width must be a whole number of limbs.");
+
+	static constexpr uint64_t unit_bits = LimbKernels::unit_bits;
+	static constexpr uint64_t limb_count = Bits / unit_bits;
+
+private:
+
+	/* Least significant limb first */
+	std::array<unit_type, limb_count> limbs_{};
+
+	[[nodiscard]] constexpr bool negative() const {
+		if constexpr (Signed) {
+			return (limbs_.back() >> (unit_bits - 1)) != 0;
+		}
+		return false;
+	}
+
+	/* Unsigned division of the full widths of n by d */
+	static constexpr void divide_magnitudes(const FixedInteger& n, const FixedInteger& d, FixedInteger& q, FixedInteger& r) {
+		uint64_t nn = LimbKernels::normalized_size(n.limbs_.data(), limb_count);
+		uint64_t dn = LimbKernels::normalized_size(d.limbs_.data(), limb_count);
+		if (dn == 0) {
+			throw ArithmeticException("Division by 0 is not allowed.");
+		}
+
+		q = FixedInteger();
+		r = FixedInteger();
+		if (LimbKernels::compare(n.limbs_.data(), nn, d.limbs_.data(), dn) < 0) {
+			r = n;
+			return;
+		}
+
+		if (dn == 1) {
+			r.limbs_[0] = LimbKernels::divrem_1(q.limbs_.data(), n.limbs_.data(), nn, d.limbs_[0]);
+			return;
+		}
+
+		/* Knuth's division needs the top bit of the divisor set, the numerator gets one more limb for the shift */
+		uint64_t shift = static_cast<uint64_t>(std::countl_zero(d.limbs_[dn - 1]));
+		std::array<unit_type, limb_count> divisor = d.limbs_;
+		std::array<unit_type, limb_count + 1> numerator{};
+		LimbKernels::copy(numerator.data(), n.limbs_.data(), nn);
+		if (shift != 0) {
+			LimbKernels::lshift(divisor.data(), d.limbs_.data(), dn, shift);
+			numerator[nn] = LimbKernels::lshift(numerator.data(), n.limbs_.data(), nn, shift);
+		}
+
+		Division::divrem(q.limbs_.data(), numerator.data(), nn + 1, divisor.data(), dn);
+		if (shift != 0) {
+			LimbKernels::rshift(numerator.data(), numerator.data(), dn, shift);
+		}
+		LimbKernels::copy(r.limbs_.data(), numerator.data(), dn);
+	}
+
+public:
+
+	constexpr FixedInteger() = default;
+
+	template<Integer T>
+	constexpr FixedInteger(T value) {
+		/* At least a limb wide, so the conversion extends the sign */
+		using wide_type = std::conditional_t<(sizeof(T) > sizeof(unit_type)), unsigned_integer_t<T>, unit_type>;
+		auto bits = static_cast<wide_type>(value);
+		unit_type fill = 0;
+		if constexpr (std::is_signed_v<T>) {
+			fill = value < 0 ? ~static_cast<unit_type>(0) : 0;
+		}
+
+		limbs_.fill(fill);
+		for (uint64_t i = 0; i < limb_count && i * unit_bits < sizeof(T) * CHAR_BIT; i++) {
+			limbs_[i] = static_cast<unit_type>(bits);
+			if constexpr (sizeof(wide_type) > sizeof(unit_type)) {
+				bits >>= unit_bits;
+			}
+		}
+	}
+
+	/* The value modulo 2^Bits */
+	constexpr explicit FixedInteger(const BigInteger& number) {
+		BigIntegerView view = number.view();
+		LimbKernels::copy(limbs_.data(), view.data(), std::min(view.size(), limb_count));
+		if (view.is_negative()) {
+			*this = -*this;
+		}
+	}
+
+	constexpr explicit operator BigInteger() const {
+		FixedInteger magnitude = this->negative() ? -*this : *this;
+		return BigInteger(BigIntegerView(magnitude.limbs_, this->negative()));
+	}
+
+	/* The low bits, as a cast between built in integers keeps them */
+	template<Integer T>
+	constexpr explicit operator T() const {
+		using unsigned_type = unsigned_integer_t<T>;
+		unsigned_type bits = 0;
+		for (uint64_t i = std::min(limb_count, (sizeof(T) * CHAR_BIT + unit_bits - 1) / unit_bits); i > 0; i--) {
+			if constexpr (sizeof(unsigned_type) > sizeof(unit_type)) {
+				bits <<= unit_bits;
+			}
+			bits |= static_cast<unsigned_type>(limbs_[i - 1]);
+		}
+		return static_cast<T>(bits);
+	}
+
+	constexpr explicit operator bool() const {
+		return limbs_ != std::array<unit_type, limb_count>{};
+	}
+
+	[[nodiscard]] static constexpr FixedInteger max() {
+		FixedInteger result;
+		result.limbs_.fill(~static_cast<unit_type>(0));
+		if constexpr (Signed) {
+			result.limbs_.back() >>= 1;
+		}
+		return result;
+	}
+
+	[[nodiscard]] static constexpr FixedInteger min() {
+		FixedInteger result;
+		if constexpr (Signed) {
+			result.limbs_.back() = static_cast<unit_type>(1) << (unit_bits - 1);
+		}
+		return result;
+	}
+
+	/* Two's complement limbs, least significant first */
+	[[nodiscard]] constexpr std::span<const unit_type, limb_count> limbs() const {
+		return limbs_;
+	}
+
+	constexpr FixedInteger& operator+=(const FixedInteger& other) {
+		unit_type carry = 0;
+		for (uint64_t i = 0; i < limb_count; i++) {
+			next_type sum = static_cast<next_type>(limbs_[i]) + other.limbs_[i] + carry;
+			limbs_[i] = static_cast<unit_type>(sum);
+			carry = static_cast<unit_type>(sum >> unit_bits);
+		}
+		return *this;
+	}
+
+	constexpr FixedInteger& operator-=(const FixedInteger& other) {
+		unit_type borrow = 0;
+		for (uint64_t i = 0; i < limb_count; i++) {
+			next_type difference = static_cast<next_type>(limbs_[i]) - other.limbs_[i] - borrow;
+			limbs_[i] = static_cast<unit_type>(difference);
+			borrow = static_cast<unit_type>(difference >> unit_bits) & 1;
+		}
+		return *this;
+	}
+
+	/* Low half of the schoolbook product, the same bits for signed and unsigned operands */
+	constexpr FixedInteger& operator*=(const FixedInteger& other) {
+		std::array<unit_type, limb_count> product{};
+		for (uint64_t i = 0; i < limb_count; i++) {
+			unit_type carry = 0;
+			for (uint64_t j = 0; i + j < limb_count; j++) {
+				next_type term = static_cast<next_type>(limbs_[i]) * other.limbs_[j] + product[i + j] + carry;
+				product[i + j] = static_cast<unit_type>(term);
+				carry = static_cast<unit_type>(term >> unit_bits);
+			}
+		}
+		limbs_ = product;
+		return *this;
+	}
+
+	constexpr FixedInteger& operator/=(const FixedInteger& other) {
+		return *this = FixedInteger::divmod(*this, other).first;
+	}
+
+	constexpr FixedInteger& operator%=(const FixedInteger& other) {
+		return *this = FixedInteger::divmod(*this, other).second;
+	}
+
+	/* Shifting by Bits or more leaves no bits, or only copies of the sign bit on the right */
+	constexpr FixedInteger& operator<<=(uint64_t count) {
+		uint64_t units = count / unit_bits;
+		uint64_t bits = count % unit_bits;
+		for (uint64_t i = limb_count; i > 0; i--) {
+			uint64_t index = i - 1;
+			unit_type value = index >= units ? limbs_[index - units] << bits : 0;
+			if (bits != 0 && index > units) {
+				value |= limbs_[index - units - 1] >> (unit_bits - bits);
+			}
+			limbs_[index] = value;
+		}
+		return *this;
+	}
+
+	constexpr FixedInteger& operator>>=(uint64_t count) {
+		unit_type fill = this->negative() ? ~static_cast<unit_type>(0) : 0;
+		uint64_t units = count / unit_bits;
+		uint64_t bits = count % unit_bits;
+		for (uint64_t i = 0; i < limb_count; i++) {
+			unit_type low = units < limb_count - i ? limbs_[i + units] : fill;
+			if (bits != 0) {
+				unit_type high = units + 1 < limb_count - i ? limbs_[i + units + 1] : fill;
+				low = (low >> bits) | (high << (unit_bits - bits));
+			}
+			limbs_[i] = low;
+		}
+		return *this;
+	}
+
+	constexpr FixedInteger& operator&=(const FixedInteger& other) {
+		for (uint64_t i = 0; i < limb_count; i++) {
+			limbs_[i] &= other.limbs_[i];
+		}
+		return *this;
+	}
+
+	constexpr FixedInteger& operator|=(const FixedInteger& other) {
+		for (uint64_t i = 0; i < limb_count; i++) {
+			limbs_[i] |= other.limbs_[i];
+		}
+		return *this;
+	}
+
+	constexpr FixedInteger& operator^=(const FixedInteger& other) {
+		for (uint64_t i = 0; i < limb_count; i++) {
+			limbs_[i] ^= other.limbs_[i];
+		}
+		return *this;
+	}
+
+	constexpr FixedInteger operator~() const {
+		FixedInteger result;
+		for (uint64_t i = 0; i < limb_count; i++) {
+			result.limbs_[i] = ~limbs_[i];
+		}
+		return result;
+	}
+
+	constexpr FixedInteger operator-() const {
+		FixedInteger result = ~*this;
+		return ++result;
+	}
+
+	constexpr FixedInteger& operator++() {
+		for (uint64_t i = 0; i < limb_count && ++limbs_[i] == 0; i++) {
+		}
+		return *this;
+	}
+
+	constexpr FixedInteger& operator--() {
+		for (uint64_t i = 0; i < limb_count && limbs_[i]-- == 0; i++) {
+		}
+		return *this;
+	}
+
+	constexpr FixedInteger operator++(int32_t) {
+		FixedInteger copy = *this;
+		++(*this);
+		return copy;
+	}
+
+	constexpr FixedInteger operator--(int32_t) {
+		FixedInteger copy = *this;
+		--(*this);
+		return copy;
+	}
+
+	/* Quotient truncated towards zero and remainder with the sign of the dividend, min() / -1 wraps to min() */
+	[[nodiscard]] static constexpr std::pair<FixedInteger, FixedInteger> divmod(const FixedInteger& dividend,
+																			   const FixedInteger& divisor) {
+		bool dividend_negative = dividend.negative();
+		bool divisor_negative = divisor.negative();
+		std::pair<FixedInteger, FixedInteger> result;
+		FixedInteger::divide_magnitudes(dividend_negative ? -dividend : dividend, divisor_negative ? -divisor : divisor,
+										result.first, result.second);
+		if (dividend_negative != divisor_negative) {
+			result.first = -result.first;
+		}
+		if (dividend_negative) {
+			result.second = -result.second;
+		}
+		return result;
+	}
+
+	friend constexpr FixedInteger operator+(FixedInteger first, const FixedInteger& second) {
+		return first += second;
+	}
+
+	friend constexpr FixedInteger operator-(FixedInteger first, const FixedInteger& second) {
+		return first -= second;
+	}
+
+	friend constexpr FixedInteger operator*(FixedInteger first, const FixedInteger& second) {
+		return first *= second;
+	}
+
+	friend constexpr FixedInteger operator/(const FixedInteger& first, const FixedInteger& second) {
+		return FixedInteger::divmod(first, second).first;
+	}
+
+	friend constexpr FixedInteger operator%(const FixedInteger& first, const FixedInteger& second) {
+		return FixedInteger::divmod(first, second).second;
+	}
+
+	friend constexpr FixedInteger operator<<(FixedInteger value, uint64_t count) {
+		return value <<= count;
+	}
+
+	friend constexpr FixedInteger operator>>(FixedInteger value, uint64_t count) {
+		return value >>= count;
+	}
+
+	friend constexpr FixedInteger operator&(FixedInteger first, const FixedInteger& second) {
+		return first &= second;
+	}
+
+	friend constexpr FixedInteger operator|(FixedInteger first, const FixedInteger& second) {
+		return first |= second;
+	}
+
+	friend constexpr FixedInteger operator^(FixedInteger first, const FixedInteger& second) {
+		return first ^= second;
+	}
+
+	friend constexpr bool operator==(const FixedInteger& first, const FixedInteger& second) = default;
+
+	friend constexpr std::strong_ordering operator<=>(const FixedInteger& first, const FixedInteger& second) {
+		if (first.negative() != second.negative()) {
+			return first.negative() ? std::strong_ordering::less : std::strong_ordering::greater;
+		}
+
+		/* With equal signs the two's complement limbs order like the values */
+		for (uint64_t i = limb_count; i > 0; i--) {
+			if (first.limbs_[i - 1] != second.limbs_[i - 1]) {
+				return first.limbs_[i - 1] <=> second.limbs_[i - 1];
+			}
+		}
+		return std::strong_ordering::equal;
+	}
+
+	friend std::ostream& operator<<(std::ostream& os, const FixedInteger& number) {
+		return os << static_cast<BigInteger>(number);
+	}
+};
+
+using Int128 = FixedInteger<128>;
+using Int256 = FixedInteger<256>;
+using Int512 = FixedInteger<512>;
+using Int1024 = FixedInteger<1024>;
+using UInt128 = FixedInteger<128, false>;
+using UInt256 = FixedInteger<256, false>;
+using UInt512 = FixedInteger<512, false>;
+using UInt1024 = FixedInteger<1024, false>;
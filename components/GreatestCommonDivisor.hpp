@@ -0,0 +1,122 @@
+#pragma once
+
+#include <bit>
+#include <cstdint>
+#include <utility>
+#include <algorithm>
+
+#include <LimbKernels.hpp>
+
+class GreatestCommonDivisor {
+public:
+	using unit_type = LimbKernels::unit_type;
+	using next_type = LimbKernels::next_type;
+
+	/* Operand size in limbs from which gcd switches from Lehmer's algorithm to the half gcd */
+	static constexpr uint64_t half_gcd_threshold = 120;
+
+	/* Bits of the leading parts Lehmer's algorithm works on */
+	static constexpr uint64_t lehmer_bits = 2 * LimbKernels::unit_bits;
+
+	/* (a, b) = M (alpha, beta) with non negative entries, the determinant is -1 when negative is set and 1 otherwise */
+	struct Matrix {
+		unit_type m00 = 1;
+		unit_type m01 = 0;
+		unit_type m10 = 0;
+		unit_type m11 = 1;
+		bool negative = false;
+	};
+
+	/* Stein's binary gcd of two words */
+	static constexpr unit_type gcd_1(unit_type u, unit_type v) {
+		if (u == 0 || v == 0) {
+			return u | v;
+		}
+
+		int32_t shift = std::countr_zero(u | v);
+		u >>= std::countr_zero(u);
+		do {
+			v >>= std::countr_zero(v);
+			if (u > v) {
+				std::swap(u, v);
+			}
+			v -= u;
+		} while (v != 0);
+		return u << shift;
+	}
+
+	/* The lehmer_bits bits of a (n limbs) starting at bit shift, past the top they read as zero */
+	static constexpr next_type extract(const unit_type* a, uint64_t n, uint64_t shift) {
+		uint64_t index = shift / LimbKernels::unit_bits;
+		uint64_t offset = shift % LimbKernels::unit_bits;
+		auto limb = [a, n](uint64_t i) { return i < n ? a[i] : unit_type(0); };
+
+		next_type low = limb(index) >> offset;
+		next_type middle = limb(index + 1);
+		next_type high = limb(index + 2);
+		if (offset != 0) {
+			low |= static_cast<next_type>(limb(index + 1)) << (LimbKernels::unit_bits - offset);
+			middle = static_cast<next_type>(limb(index + 1) >> offset) | (high << (LimbKernels::unit_bits - offset));
+		}
+		return low | (middle << LimbKernels::unit_bits);
+	}
+
+	/*
+	 * Euclid's algorithm on a >= b, the leading bits of two numbers truncated by the same shift, collecting the quotients
+	 * in m. Unless the numbers are exact, it stops before the first quotient the truncated bits could change, so m is a
+	 * prefix of the quotient sequence of the full numbers. It also stops before a remainder could fall below minimum,
+	 * counted in units of the truncated numbers, or an entry would overflow a word. Returns whether any step was taken.
+	 */
+	static constexpr bool lehmer(Matrix& m, next_type a, next_type b, bool exact, next_type minimum) {
+		m = Matrix();
+		bool progress = false;
+
+		while (b != 0) {
+			/* Most quotients are small, a few subtractions are much cheaper than a double word division */
+			next_type q = 1;
+			next_type r = a - b;
+			while (r >= b && q < 4) {
+				r -= b;
+				q += 1;
+			}
+			if (r >= b) {
+				q = a / b;
+				r = a - q * b;
+			}
+
+			next_type m00 = q * m.m00 + m.m01;
+			next_type m10 = q * m.m10 + m.m11;
+			if (q > std::numeric_limits<unit_type>::max() || (m00 | m10) > std::numeric_limits<unit_type>::max()) {
+				break;
+			}
+
+			/* The truncation moves each remainder by less than the largest entry of its column */
+			next_type error = exact ? 0 : std::max(m00, m10);
+			next_type previous_error = exact ? 0 : std::max(m.m00, m.m10);
+			if (r < minimum || r - minimum < error || b - r < error + previous_error) {
+				break;
+			}
+
+			m.m01 = m.m00;
+			m.m11 = m.m10;
+			m.m00 = static_cast<unit_type>(m00);
+			m.m10 = static_cast<unit_type>(m10);
+			m.negative = !m.negative;
+			a = b;
+			b = r;
+			progress = true;
+		}
+		return progress;
+	}
+
+	/* (alpha, beta) = M^-1 (a, b) for n limb a and b, both results are known to be non negative and to fit n limbs */
+	static constexpr void apply(unit_type* alpha, unit_type* beta, const unit_type* a, const unit_type* b, uint64_t n,
+								const Matrix& m) {
+		const unit_type* first = m.negative ? b : a;
+		const unit_type* second = m.negative ? a : b;
+		LimbKernels::mul_1(alpha, first, n, m.negative ? m.m01 : m.m11);
+		LimbKernels::submul_1(alpha, second, n, m.negative ? m.m11 : m.m01);
+		LimbKernels::mul_1(beta, second, n, m.negative ? m.m10 : m.m00);
+		LimbKernels::submul_1(beta, first, n, m.negative ? m.m00 : m.m10);
+	}
+};
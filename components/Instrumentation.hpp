@@ -0,0 +1,196 @@
+#pragma once
+
+#include <bit>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <cstdint>
+#include <utility>
+#include <string_view>
+
+/*
+ * Call counts, operand sizes, time and allocated bytes of the public operations and of the kernels under them, collected
+ * only when the library is built with BIGNUMBER_INSTRUMENTATION defined. Otherwise the macros below expand to nothing
+ * and every snapshot is empty. Sizes are in limbs of the larger operand, times include the operations nested inside and
+ * allocations count for the innermost operation running on their thread.
+ */
+#ifdef BIGNUMBER_INSTRUMENTATION
+#define BIGNUMBER_INSTRUMENT(operation, limbs) \
+	Instrumentation::Scope instrumentation_scope(Instrumentation::Operation::operation, limbs)
+#define BIGNUMBER_INSTRUMENT_ALLOCATION(bytes)	\
+	if !consteval {								\
+		Instrumentation::allocated(bytes);		\
+	}
+#else
+#define BIGNUMBER_INSTRUMENT(operation, limbs)
+#define BIGNUMBER_INSTRUMENT_ALLOCATION(bytes)
+#endif
+
+class Instrumentation {
+public:
+
+	enum class Operation : uint8_t {
+		add, multiply, divide, shift, bitwise, compare, power, root, gcd, parse, print, convert,
+		karatsuba, toom3, ntt, divide_basecase, divide_recursive, count
+	};
+
+#ifdef BIGNUMBER_INSTRUMENTATION
+	static constexpr bool enabled = true;
+#else
+	static constexpr bool enabled = false;
+#endif
+
+	static constexpr uint64_t operation_count = static_cast<uint64_t>(Operation::count);
+
+	/* Bucket i counts the operands of bit_width(limbs) == i, that is from 2^(i - 1) to 2^i - 1 limbs */
+	static constexpr uint64_t size_buckets = 65;
+
+	static constexpr std::array<std::string_view, operation_count> names = {
+		"add", "multiply", "divide", "shift", "bitwise", "compare", "power", "root", "gcd", "parse", "print", "convert",
+		"karatsuba", "toom3", "ntt", "divide_basecase", "divide_recursive"
+	};
+
+	struct Counters {
+		uint64_t calls = 0;
+		uint64_t nanoseconds = 0;
+		uint64_t bytes = 0;
+		std::array<uint64_t, size_buckets> sizes{};
+	};
+
+	struct Snapshot {
+		std::array<Counters, operation_count> operations{};
+
+		[[nodiscard]] const Counters& operator[](Operation operation) const {
+			return operations[static_cast<uint64_t>(operation)];
+		}
+
+		/* The operations that ran, with the sizes keyed by the smallest limb count of their bucket */
+		[[nodiscard]] std::string to_json() const {
+			std::string json = enabled ? "{\"enabled\":true,\"operations\":{" : "{\"enabled\":false,\"operations\":{";
+			bool first = true;
+			for (uint64_t i = 0; i < operation_count; i++) {
+				const Counters& counters = operations[i];
+				if (counters.calls == 0) {
+					continue;
+				}
+
+				json += first ? "\"" : ",\"";
+				json += names[i];
+				json += "\":{\"calls\":" + std::to_string(counters.calls) +
+						",\"nanoseconds\":" + std::to_string(counters.nanoseconds) +
+						",\"bytes\":" + std::to_string(counters.bytes) + ",\"sizes\":{";
+				bool first_size = true;
+				for (uint64_t bucket = 0; bucket < size_buckets; bucket++) {
+					if (counters.sizes[bucket] != 0) {
+						uint64_t limbs = bucket == 0 ? 0 : uint64_t(1) << (bucket - 1);
+						json += (first_size ? "\"" : ",\"") + std::to_string(limbs) + "\":" + std::to_string(counters.sizes[bucket]);
+						first_size = false;
+					}
+				}
+				json += "}}";
+				first = false;
+			}
+			return json + "}}";
+		}
+	};
+
+	class Scope;
+
+private:
+
+	struct AtomicCounters {
+		std::atomic<uint64_t> calls;
+		std::atomic<uint64_t> nanoseconds;
+		std::atomic<uint64_t> bytes;
+		std::array<std::atomic<uint64_t>, size_buckets> sizes;
+	};
+
+	static std::array<AtomicCounters, operation_count>& table() {
+		static std::array<AtomicCounters, operation_count> counters{};
+		return counters;
+	}
+
+	static AtomicCounters& counters(Operation operation) {
+		return Instrumentation::table()[static_cast<uint64_t>(operation)];
+	}
+
+	static Scope*& innermost() {
+		thread_local Scope* scope = nullptr;
+		return scope;
+	}
+
+	static uint64_t now() {
+		auto time = std::chrono::steady_clock::now().time_since_epoch();
+		return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(time).count());
+	}
+
+public:
+
+	/* Records one call of the operation for as long as it lives */
+	class Scope {
+	private:
+		Operation operation_;
+		Scope* parent_ = nullptr;
+		uint64_t start_ = 0;
+
+		friend class Instrumentation;
+
+	public:
+
+		constexpr Scope(Operation operation, uint64_t limbs) : operation_(operation) {
+			if !consteval {
+				AtomicCounters& counters = Instrumentation::counters(operation);
+				counters.calls.fetch_add(1, std::memory_order_relaxed);
+				counters.sizes[static_cast<uint64_t>(std::bit_width(limbs))].fetch_add(1, std::memory_order_relaxed);
+				parent_ = std::exchange(Instrumentation::innermost(), this);
+				start_ = Instrumentation::now();
+			}
+		}
+
+		Scope(const Scope&) = delete;
+		Scope& operator=(const Scope&) = delete;
+
+		constexpr ~Scope() {
+			if !consteval {
+				Instrumentation::counters(operation_).nanoseconds.fetch_add(Instrumentation::now() - start_, std::memory_order_relaxed);
+				Instrumentation::innermost() = parent_;
+			}
+		}
+	};
+
+	static void allocated(uint64_t bytes) {
+		if (Scope* scope = Instrumentation::innermost()) {
+			Instrumentation::counters(scope->operation_).bytes.fetch_add(bytes, std::memory_order_relaxed);
+		}
+	}
+
+	[[nodiscard]] static Snapshot snapshot() {
+		Snapshot snapshot;
+		if constexpr (enabled) {
+			for (uint64_t i = 0; i < operation_count; i++) {
+				const AtomicCounters& counters = Instrumentation::table()[i];
+				snapshot.operations[i].calls = counters.calls.load(std::memory_order_relaxed);
+				snapshot.operations[i].nanoseconds = counters.nanoseconds.load(std::memory_order_relaxed);
+				snapshot.operations[i].bytes = counters.bytes.load(std::memory_order_relaxed);
+				for (uint64_t bucket = 0; bucket < size_buckets; bucket++) {
+					snapshot.operations[i].sizes[bucket] = counters.sizes[bucket].load(std::memory_order_relaxed);
+				}
+			}
+		}
+		return snapshot;
+	}
+
+	static void reset() {
+		if constexpr (enabled) {
+			for (AtomicCounters& counters : Instrumentation::table()) {
+				counters.calls.store(0, std::memory_order_relaxed);
+				counters.nanoseconds.store(0, std::memory_order_relaxed);
+				counters.bytes.store(0, std::memory_order_relaxed);
+				for (std::atomic<uint64_t>& size : counters.sizes) {
+					size.store(0, std::memory_order_relaxed);
+				}
+			}
+		}
+	}
+};
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+#include <cstddef>
+#include <type_traits>
+#include <memory_resource>
+
+#include <Instrumentation.hpp>
+#include <LimbKernels.hpp>
+#include <LimbResource.hpp>
+
+/*
+ * Allocator bound to the resource current on its thread when it was constructed. Copies of containers take the resource
+ * current at the copy, moves keep it. Without a resource, and during constant evaluation, it falls back to std::allocator.
+ */
+template<typename T>
+class LimbAllocator {
+private:
+	std::pmr::memory_resource* resource_ = nullptr;
+
+public:
+	using value_type = T;
+	using propagate_on_container_copy_assignment = std::false_type;
+	using propagate_on_container_move_assignment = std::false_type;
+	using propagate_on_container_swap = std::false_type;
+	using is_always_equal = std::false_type;
+
+	constexpr LimbAllocator() {
+		if !consteval {
+			resource_ = LimbResource::current();
+		}
+	}
+
+	constexpr explicit LimbAllocator(std::pmr::memory_resource* resource) : resource_(resource) {}
+
+	template<typename U>
+	constexpr LimbAllocator(const LimbAllocator<U>& other) : resource_(other.resource()) {}
+
+	[[nodiscard]] constexpr std::pmr::memory_resource* resource() const {
+		return resource_;
+	}
+
+	[[nodiscard]] constexpr T* allocate(std::size_t n) {
+		BIGNUMBER_INSTRUMENT_ALLOCATION(n * sizeof(T));
+		if (resource_ == nullptr) {
+			return std::allocator<T>().allocate(n);
+		}
+		return static_cast<T*>(resource_->allocate(n * sizeof(T), alignof(T)));
+	}
+
+	constexpr void deallocate(T* pointer, std::size_t n) {
+		if (resource_ == nullptr) {
+			std::allocator<T>().deallocate(pointer, n);
+			return;
+		}
+		resource_->deallocate(pointer, n * sizeof(T), alignof(T));
+	}
+
+	[[nodiscard]] constexpr LimbAllocator select_on_container_copy_construction() const {
+		return LimbAllocator();
+	}
+
+	template<typename U>
+	friend constexpr bool operator==(const LimbAllocator& first, const LimbAllocator<U>& second) {
+		return first.resource_ == second.resource() ||
+			   (first.resource_ != nullptr && second.resource() != nullptr && first.resource_->is_equal(*second.resource()));
+	}
+};
+
+/* Scratch limbs of the arithmetic kernels, allocated from the current resource */
+using limb_vector = std::vector<LimbKernels::unit_type, LimbAllocator<LimbKernels::unit_type>>;
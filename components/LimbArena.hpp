@@ -0,0 +1,120 @@
+#pragma once
+
+#include <memory>
+#include <utility>
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+#include <memory_resource>
+
+/*
+ * Bump pointer resource for the limb buffers of one computation. Allocations are carved from chunks that double in size,
+ * only the most recent one can be given back early, which is the common case for kernel scratch. release() frees
+ * everything at once and keeps the largest chunk for the next computation, the destructor hands it back upstream.
+ */
+class LimbArena : public std::pmr::memory_resource {
+private:
+
+	struct Chunk {
+		Chunk* previous;
+		std::size_t size;
+	};
+
+	static constexpr std::size_t initial_chunk_size = 4096;
+
+	std::pmr::memory_resource* upstream_;
+	Chunk* chunks_ = nullptr;
+	Chunk* spare_ = nullptr;
+	std::byte* buffer_ = nullptr;
+	std::size_t buffer_size_ = 0;
+	std::byte* current_ = nullptr;
+	std::byte* end_ = nullptr;
+	std::byte* last_ = nullptr;
+	std::size_t next_chunk_size_;
+
+	void add_chunk(std::size_t bytes, std::size_t alignment) {
+		std::size_t size = std::max(next_chunk_size_, sizeof(Chunk) + bytes + alignment);
+		Chunk* chunk = spare_;
+		if (chunk != nullptr && chunk->size >= size) {
+			size = chunk->size;
+			spare_ = nullptr;
+		} else {
+			chunk = static_cast<Chunk*>(upstream_->allocate(size, alignof(std::max_align_t)));
+		}
+		chunk->previous = chunks_;
+		chunk->size = size;
+		chunks_ = chunk;
+		current_ = reinterpret_cast<std::byte*>(chunk + 1);
+		end_ = reinterpret_cast<std::byte*>(chunk) + size;
+		next_chunk_size_ = 2 * size;
+	}
+
+	void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+		void* pointer = current_;
+		std::size_t space = static_cast<std::size_t>(end_ - current_);
+		if (current_ == nullptr || std::align(alignment, bytes, pointer, space) == nullptr) {
+			this->add_chunk(bytes, alignment);
+			pointer = current_;
+			space = static_cast<std::size_t>(end_ - current_);
+			std::align(alignment, bytes, pointer, space);
+		}
+
+		last_ = static_cast<std::byte*>(pointer);
+		current_ = last_ + bytes;
+		return pointer;
+	}
+
+	void do_deallocate(void* pointer, std::size_t bytes, std::size_t) override {
+		if (pointer == last_ && last_ + bytes == current_) {
+			current_ = last_;
+			last_ = nullptr;
+		}
+	}
+
+	[[nodiscard]] bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+		return this == &other;
+	}
+
+public:
+
+	explicit LimbArena(std::pmr::memory_resource* upstream = std::pmr::new_delete_resource())
+		: upstream_(upstream), next_chunk_size_(initial_chunk_size) {}
+
+	/* Starts from a caller provided buffer, such as an array on the stack, before going upstream */
+	LimbArena(void* buffer, std::size_t size, std::pmr::memory_resource* upstream = std::pmr::new_delete_resource())
+		: upstream_(upstream), buffer_(static_cast<std::byte*>(buffer)), buffer_size_(size), current_(buffer_),
+		  end_(buffer_ + size), next_chunk_size_(std::max(initial_chunk_size, 2 * size)) {}
+
+	LimbArena(const LimbArena&) = delete;
+	LimbArena& operator=(const LimbArena&) = delete;
+
+	~LimbArena() override {
+		this->release();
+		if (spare_ != nullptr) {
+			upstream_->deallocate(spare_, spare_->size, alignof(std::max_align_t));
+		}
+	}
+
+	/* Frees everything allocated so far, numbers still using the arena are left dangling */
+	void release() {
+		while (chunks_ != nullptr) {
+			Chunk* previous = chunks_->previous;
+			if (spare_ == nullptr || chunks_->size > spare_->size) {
+				std::swap(chunks_, spare_);
+			}
+			if (chunks_ != nullptr) {
+				upstream_->deallocate(chunks_, chunks_->size, alignof(std::max_align_t));
+			}
+			chunks_ = previous;
+		}
+
+		current_ = buffer_;
+		end_ = buffer_ == nullptr ? nullptr : buffer_ + buffer_size_;
+		last_ = nullptr;
+		next_chunk_size_ = std::max(initial_chunk_size, 2 * buffer_size_);
+	}
+
+	[[nodiscard]] std::pmr::memory_resource* upstream_resource() const {
+		return upstream_;
+	}
+};
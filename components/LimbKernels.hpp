@@ -0,0 +1,394 @@
+#pragma once
+
+#include <bit>
+#include <cstdint>
+#include <climits>
+#include <type_traits>
+
+#include <Traits.hpp>
+#include <LimbKernelsX86.hpp>
+
+/*
+ * Loops over limb arrays. At run time on x86-64 the carry chains of add_n, sub_n, the multiply by one limb and the bit
+ * count go to LimbKernelsX86 when the processor has the instructions, the *_portable loops are the fallback and run at
+ * compile time.
+ */
+class LimbKernels {
+public:
+	using unit_type = uint64_t;
+	using next_type = next_integer_type_t<unit_type>;
+
+	static constexpr uint64_t unit_bits = CHAR_BIT * sizeof(unit_type);
+
+	static constexpr uint64_t normalized_size(const unit_type* a, uint64_t n) {
+		while (n != 0 && a[n - 1] == 0) {
+			n -= 1;
+		}
+		return n;
+	}
+
+	static constexpr uint64_t popcount_portable(const unit_type* a, uint64_t n) {
+		uint64_t count = 0;
+		for (uint64_t i = 0; i < n; i++) {
+			count += static_cast<uint64_t>(std::popcount(a[i]));
+		}
+		return count;
+	}
+
+	static constexpr uint64_t popcount(const unit_type* a, uint64_t n) {
+#if defined(__x86_64__)
+		if !consteval {
+			if (CpuFeatures::popcnt()) {
+				return LimbKernelsX86::popcount(a, n);
+			}
+		}
+#endif
+		return popcount_portable(a, n);
+	}
+
+	static constexpr void copy(unit_type* r, const unit_type* a, uint64_t n) {
+		for (uint64_t i = 0; i < n; i++) {
+			r[i] = a[i];
+		}
+	}
+
+	static constexpr void zero(unit_type* r, uint64_t n) {
+		for (uint64_t i = 0; i < n; i++) {
+			r[i] = 0;
+		}
+	}
+
+	static constexpr int32_t compare_n(const unit_type* a, const unit_type* b, uint64_t n) {
+		while (n != 0) {
+			n -= 1;
+			if (a[n] != b[n]) {
+				return a[n] < b[n] ? -1 : 1;
+			}
+		}
+		return 0;
+	}
+
+	/* Both operands must be normalized */
+	static constexpr int32_t compare(const unit_type* a, uint64_t an, const unit_type* b, uint64_t bn) {
+		if (an != bn) {
+			return an < bn ? -1 : 1;
+		}
+		return compare_n(a, b, an);
+	}
+
+	static constexpr unit_type add_n_portable(unit_type* r, const unit_type* a, const unit_type* b, uint64_t n) {
+		unit_type carry = 0;
+		for (uint64_t i = 0; i < n; i++) {
+			unit_type sum = a[i] + carry;
+			carry = sum < carry;
+			r[i] = sum + b[i];
+			carry += r[i] < sum;
+		}
+		return carry;
+	}
+
+	static constexpr unit_type add_n(unit_type* r, const unit_type* a, const unit_type* b, uint64_t n) {
+#if defined(__x86_64__)
+		if !consteval {
+			return LimbKernelsX86::add_n(r, a, b, n);
+		}
+#endif
+		return add_n_portable(r, a, b, n);
+	}
+
+	static constexpr unit_type add_1(unit_type* r, const unit_type* a, uint64_t n, unit_type b) {
+		for (uint64_t i = 0; i < n; i++) {
+			r[i] = a[i] + b;
+			b = r[i] < b;
+		}
+		return b;
+	}
+
+	/* Requires an >= bn */
+	static constexpr unit_type add(unit_type* r, const unit_type* a, uint64_t an, const unit_type* b, uint64_t bn) {
+		unit_type carry = add_n(r, a, b, bn);
+		return add_1(r + bn, a + bn, an - bn, carry);
+	}
+
+	static constexpr unit_type sub_n_portable(unit_type* r, const unit_type* a, const unit_type* b, uint64_t n) {
+		unit_type borrow = 0;
+		for (uint64_t i = 0; i < n; i++) {
+			unit_type subtrahend = b[i] + borrow;
+			borrow = subtrahend < borrow;
+			borrow += a[i] < subtrahend;
+			r[i] = a[i] - subtrahend;
+		}
+		return borrow;
+	}
+
+	static constexpr unit_type sub_n(unit_type* r, const unit_type* a, const unit_type* b, uint64_t n) {
+#if defined(__x86_64__)
+		if !consteval {
+			return LimbKernelsX86::sub_n(r, a, b, n);
+		}
+#endif
+		return sub_n_portable(r, a, b, n);
+	}
+
+	static constexpr unit_type sub_1(unit_type* r, const unit_type* a, uint64_t n, unit_type b) {
+		for (uint64_t i = 0; i < n; i++) {
+			unit_type difference = a[i] - b;
+			b = a[i] < b;
+			r[i] = difference;
+		}
+		return b;
+	}
+
+	/* Adds b into r in place, stopping once the carry is absorbed, returns the carry out of the top limb */
+	static constexpr unit_type increment(unit_type* r, uint64_t n, unit_type b) {
+		for (uint64_t i = 0; i < n && b != 0; i++) {
+			r[i] += b;
+			b = r[i] < b;
+		}
+		return b;
+	}
+
+	/* Subtracts b from r in place, stopping once the borrow is absorbed, returns the borrow out of the top limb */
+	static constexpr unit_type decrement(unit_type* r, uint64_t n, unit_type b) {
+		for (uint64_t i = 0; i < n && b != 0; i++) {
+			unit_type difference = r[i] - b;
+			b = r[i] < b;
+			r[i] = difference;
+		}
+		return b;
+	}
+
+	/* Requires an >= bn */
+	static constexpr unit_type sub(unit_type* r, const unit_type* a, uint64_t an, const unit_type* b, uint64_t bn) {
+		unit_type borrow = sub_n(r, a, b, bn);
+		return sub_1(r + bn, a + bn, an - bn, borrow);
+	}
+
+	static constexpr unit_type mul_1_portable(unit_type* r, const unit_type* a, uint64_t n, unit_type b) {
+		unit_type carry = 0;
+		for (uint64_t i = 0; i < n; i++) {
+			next_type product = static_cast<next_type>(a[i]) * b + carry;
+			r[i] = static_cast<unit_type>(product);
+			carry = static_cast<unit_type>(product >> unit_bits);
+		}
+		return carry;
+	}
+
+	static constexpr unit_type mul_1(unit_type* r, const unit_type* a, uint64_t n, unit_type b) {
+#if defined(__x86_64__)
+		if !consteval {
+			if (CpuFeatures::bmi2()) {
+				return LimbKernelsX86::mul_1(r, a, n, b);
+			}
+		}
+#endif
+		return mul_1_portable(r, a, n, b);
+	}
+
+	static constexpr unit_type addmul_1_portable(unit_type* r, const unit_type* a, uint64_t n, unit_type b) {
+		unit_type carry = 0;
+		for (uint64_t i = 0; i < n; i++) {
+			next_type product = static_cast<next_type>(a[i]) * b + r[i] + carry;
+			r[i] = static_cast<unit_type>(product);
+			carry = static_cast<unit_type>(product >> unit_bits);
+		}
+		return carry;
+	}
+
+	static constexpr unit_type addmul_1(unit_type* r, const unit_type* a, uint64_t n, unit_type b) {
+#if defined(__x86_64__)
+		if !consteval {
+			if (CpuFeatures::adx()) {
+				return LimbKernelsX86::addmul_1(r, a, n, b);
+			}
+		}
+#endif
+		return addmul_1_portable(r, a, n, b);
+	}
+
+	static constexpr unit_type submul_1_portable(unit_type* r, const unit_type* a, uint64_t n, unit_type b) {
+		unit_type borrow = 0;
+		for (uint64_t i = 0; i < n; i++) {
+			next_type product = static_cast<next_type>(a[i]) * b + borrow;
+			unit_type low = static_cast<unit_type>(product);
+			borrow = static_cast<unit_type>(product >> unit_bits) + (r[i] < low);
+			r[i] -= low;
+		}
+		return borrow;
+	}
+
+	static constexpr unit_type submul_1(unit_type* r, const unit_type* a, uint64_t n, unit_type b) {
+#if defined(__x86_64__)
+		if !consteval {
+			if (CpuFeatures::bmi2()) {
+				return LimbKernelsX86::submul_1(r, a, n, b);
+			}
+		}
+#endif
+		return submul_1_portable(r, a, n, b);
+	}
+
+	/* Whether mul_basecase multiplies operands of these sizes on vector units, fast enough to stand in for Karatsuba */
+	static constexpr bool vector_basecase(uint64_t an, uint64_t bn) {
+#if defined(__x86_64__)
+		if !consteval {
+			return an >= bn && bn >= LimbKernelsX86::ifma_min_size && an <= LimbKernelsX86::ifma_max_size &&
+				   CpuFeatures::avx512ifma();
+		}
+#endif
+		return false;
+	}
+
+	/* r must hold an + bn limbs and must not overlap the operands */
+	static constexpr void mul_basecase(unit_type* r, const unit_type* a, uint64_t an, const unit_type* b, uint64_t bn) {
+#if defined(__x86_64__)
+		if (vector_basecase(an, bn)) {
+			LimbKernelsX86::mul_ifma(r, a, an, b, bn);
+			return;
+		}
+#endif
+		r[an] = mul_1(r, a, an, b[0]);
+		for (uint64_t i = 1; i < bn; i++) {
+			r[an + i] = addmul_1(r + i, a, an, b[i]);
+		}
+	}
+
+	/* Adds a * b into r (rn >= an + bn limbs) row by row, returns the carry out of r, r must not overlap the operands */
+	static constexpr unit_type addmul_basecase(unit_type* r, uint64_t rn, const unit_type* a, uint64_t an,
+											   const unit_type* b, uint64_t bn) {
+		unit_type carry = 0;
+		for (uint64_t i = 0; i < bn; i++) {
+			carry += increment(r + i + an, rn - i - an, addmul_1(r + i, a, an, b[i]));
+		}
+		return carry;
+	}
+
+	/* Subtracts a * b from r (rn >= an + bn limbs) row by row, returns the borrow out of r, r must not overlap the operands */
+	static constexpr unit_type submul_basecase(unit_type* r, uint64_t rn, const unit_type* a, uint64_t an,
+											   const unit_type* b, uint64_t bn) {
+		unit_type borrow = 0;
+		for (uint64_t i = 0; i < bn; i++) {
+			borrow += decrement(r + i + an, rn - i - an, submul_1(r + i, a, an, b[i]));
+		}
+		return borrow;
+	}
+
+	/* r must hold 2 * n limbs and must not overlap a, cross products are computed once and doubled */
+	static constexpr void sqr_basecase(unit_type* r, const unit_type* a, uint64_t n) {
+		r[0] = 0;
+		r[n] = mul_1(r + 1, a + 1, n - 1, a[0]);
+		for (uint64_t i = 1; i + 1 < n; i++) {
+			r[n + i] = addmul_1(r + 2 * i + 1, a + i + 1, n - i - 1, a[i]);
+		}
+		r[2 * n - 1] = 0;
+		lshift(r, r, 2 * n, 1);
+
+		unit_type carry = 0;
+		for (uint64_t i = 0; i < n; i++) {
+			next_type square = static_cast<next_type>(a[i]) * a[i];
+			next_type sum = static_cast<next_type>(r[2 * i]) + static_cast<unit_type>(square) + carry;
+			r[2 * i] = static_cast<unit_type>(sum);
+			sum = (sum >> unit_bits) + r[2 * i + 1] + static_cast<unit_type>(square >> unit_bits);
+			r[2 * i + 1] = static_cast<unit_type>(sum);
+			carry = static_cast<unit_type>(sum >> unit_bits);
+		}
+	}
+
+	/* floor((B^2 - 1) / d) - B for a normalized d */
+	static constexpr unit_type reciprocal(unit_type d) {
+		next_type numerator = (static_cast<next_type>(~d) << unit_bits) | ~static_cast<unit_type>(0);
+		return static_cast<unit_type>(numerator / d);
+	}
+
+	/* Divides u1:u0 by a normalized d with u1 < d using its reciprocal v, returns the remainder */
+	static constexpr unit_type divrem_2by1(unit_type& q, unit_type u1, unit_type u0, unit_type d, unit_type v) {
+		next_type estimate = static_cast<next_type>(v) * u1 + ((static_cast<next_type>(u1) << unit_bits) | u0);
+		unit_type q1 = static_cast<unit_type>(estimate >> unit_bits) + 1;
+		unit_type q0 = static_cast<unit_type>(estimate);
+		unit_type r = u0 - q1 * d;
+
+		if (r > q0) {
+			q1 -= 1;
+			r += d;
+		}
+		if (r >= d) {
+			q1 += 1;
+			r -= d;
+		}
+
+		q = q1;
+		return r;
+	}
+
+	/* q may alias a, returns the remainder */
+	static constexpr unit_type divrem_1(unit_type* q, const unit_type* a, uint64_t n, unit_type d) {
+		uint64_t shift = static_cast<uint64_t>(std::countl_zero(d));
+		unit_type v = reciprocal(d << shift);
+		unit_type remainder = 0;
+
+		d <<= shift;
+		if (shift == 0) {
+			while (n != 0) {
+				n -= 1;
+				remainder = divrem_2by1(q[n], remainder, a[n], d, v);
+			}
+			return remainder;
+		}
+
+		if (n != 0) {
+			remainder = a[n - 1] >> (unit_bits - shift);
+		}
+		while (n != 0) {
+			n -= 1;
+			unit_type low = a[n] << shift;
+			if (n != 0) {
+				low |= a[n - 1] >> (unit_bits - shift);
+			}
+			remainder = divrem_2by1(q[n], remainder, low, d, v);
+		}
+		return remainder >> shift;
+	}
+
+	/* Remainder of a divided by d, without the quotient */
+	static constexpr unit_type mod_1(const unit_type* a, uint64_t n, unit_type d) {
+		uint64_t shift = static_cast<uint64_t>(std::countl_zero(d));
+		unit_type v = reciprocal(d << shift);
+		unit_type remainder = 0;
+		unit_type q = 0;
+
+		d <<= shift;
+		for (uint64_t i = n; i > 0; i--) {
+			unit_type low = a[i - 1] << shift;
+			if (shift != 0) {
+				if (i == n) {
+					remainder = a[i - 1] >> (unit_bits - shift);
+				}
+				if (i > 1) {
+					low |= a[i - 2] >> (unit_bits - shift);
+				}
+			}
+			remainder = divrem_2by1(q, remainder, low, d, v);
+		}
+		return remainder >> shift;
+	}
+
+	/* Requires 0 < count < unit_bits, r may overlap a from above, returns the bits shifted out of the top limb */
+	static constexpr unit_type lshift(unit_type* r, const unit_type* a, uint64_t n, uint64_t count) {
+		unit_type out = a[n - 1] >> (unit_bits - count);
+		for (uint64_t i = n - 1; i > 0; i--) {
+			r[i] = (a[i] << count) | (a[i - 1] >> (unit_bits - count));
+		}
+		r[0] = a[0] << count;
+		return out;
+	}
+
+	/* Requires 0 < count < unit_bits, r may overlap a from below, returns the bits shifted out of the bottom limb in the high end */
+	static constexpr unit_type rshift(unit_type* r, const unit_type* a, uint64_t n, uint64_t count) {
+		unit_type out = a[0] << (unit_bits - count);
+		for (uint64_t i = 0; i + 1 < n; i++) {
+			r[i] = (a[i] >> count) | (a[i + 1] << (unit_bits - count));
+		}
+		r[n - 1] = a[n - 1] >> count;
+		return out;
+	}
+};
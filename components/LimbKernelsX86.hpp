@@ -0,0 +1,384 @@
+#pragma once
+
+#include <cstdint>
+
+#include <Traits.hpp>
+
+#if defined(__x86_64__)
+
+#include <array>
+#include <algorithm>
+#include <immintrin.h>
+
+/* Instruction set extensions of the running processor, detected once */
+class CpuFeatures {
+private:
+	bool popcnt_ = false;
+	bool adx_ = false;
+	bool bmi2_ = false;
+	bool avx512ifma_ = false;
+
+	CpuFeatures() {
+		__builtin_cpu_init();
+		popcnt_ = __builtin_cpu_supports("popcnt");
+		adx_ = __builtin_cpu_supports("adx");
+		bmi2_ = __builtin_cpu_supports("bmi2");
+		avx512ifma_ = __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512ifma");
+	}
+
+	static const CpuFeatures& get() {
+		static const CpuFeatures features;
+		return features;
+	}
+
+public:
+
+	[[nodiscard]] static bool popcnt() {
+		return CpuFeatures::get().popcnt_;
+	}
+
+	/* mulx */
+	[[nodiscard]] static bool bmi2() {
+		return CpuFeatures::get().bmi2_;
+	}
+
+	/* mulx with the two carry chains of adcx and adox */
+	[[nodiscard]] static bool adx() {
+		return CpuFeatures::get().adx_ && CpuFeatures::get().bmi2_;
+	}
+
+	/* 52 bit multiply accumulate on 512 bit vectors */
+	[[nodiscard]] static bool avx512ifma() {
+		return CpuFeatures::get().avx512ifma_;
+	}
+};
+
+/*
+ * Limb loops as carry chains in inline assembly. Add and subtract only need adc and sbb, which every x86-64 has, the
+ * multiplications need the extensions named on them. The loops step through the limbs with lea, dec and jrcxz, which
+ * leave the carry flags alone, so a chain runs from the first limb to the last. The statements are volatile because
+ * callers often drop the carry, which would otherwise let the compiler discard the stores along with it.
+ */
+class LimbKernelsX86 {
+public:
+	using unit_type = uint64_t;
+	using next_type = next_integer_type_t<unit_type>;
+
+	static unit_type add_n(unit_type* r, const unit_type* a, const unit_type* b, uint64_t n) {
+		uint64_t count = n % 4;
+		unit_type carry, t0, t1;
+		__asm__ volatile (
+			"xorl %k[carry], %k[carry]\n\t"
+			"jrcxz 2f\n"
+			"1:\n\t"
+			"movq (%[a]), %[t0]\n\t"
+			"adcq (%[b]), %[t0]\n\t"
+			"movq %[t0], (%[r])\n\t"
+			"leaq 8(%[a]), %[a]\n\t"
+			"leaq 8(%[b]), %[b]\n\t"
+			"leaq 8(%[r]), %[r]\n\t"
+			"decq %%rcx\n\t"
+			"jnz 1b\n"
+			"2:\n\t"
+			"movq %[quads], %%rcx\n\t"
+			"jrcxz 4f\n"
+			"3:\n\t"
+			"movq (%[a]), %[t0]\n\t"
+			"movq 8(%[a]), %[t1]\n\t"
+			"adcq (%[b]), %[t0]\n\t"
+			"adcq 8(%[b]), %[t1]\n\t"
+			"movq %[t0], (%[r])\n\t"
+			"movq %[t1], 8(%[r])\n\t"
+			"movq 16(%[a]), %[t0]\n\t"
+			"movq 24(%[a]), %[t1]\n\t"
+			"adcq 16(%[b]), %[t0]\n\t"
+			"adcq 24(%[b]), %[t1]\n\t"
+			"movq %[t0], 16(%[r])\n\t"
+			"movq %[t1], 24(%[r])\n\t"
+			"leaq 32(%[a]), %[a]\n\t"
+			"leaq 32(%[b]), %[b]\n\t"
+			"leaq 32(%[r]), %[r]\n\t"
+			"decq %%rcx\n\t"
+			"jnz 3b\n"
+			"4:\n\t"
+			"setc %b[carry]\n\t"
+			: [carry] "=&r" (carry), [t0] "=&r" (t0), [t1] "=&r" (t1), [r] "+r" (r), [a] "+r" (a), [b] "+r" (b),
+			  "+c" (count)
+			: [quads] "r" (n / 4)
+			: "cc", "memory"
+		);
+		return carry;
+	}
+
+	static unit_type sub_n(unit_type* r, const unit_type* a, const unit_type* b, uint64_t n) {
+		uint64_t count = n % 4;
+		unit_type borrow, t0, t1;
+		__asm__ volatile (
+			"xorl %k[borrow], %k[borrow]\n\t"
+			"jrcxz 2f\n"
+			"1:\n\t"
+			"movq (%[a]), %[t0]\n\t"
+			"sbbq (%[b]), %[t0]\n\t"
+			"movq %[t0], (%[r])\n\t"
+			"leaq 8(%[a]), %[a]\n\t"
+			"leaq 8(%[b]), %[b]\n\t"
+			"leaq 8(%[r]), %[r]\n\t"
+			"decq %%rcx\n\t"
+			"jnz 1b\n"
+			"2:\n\t"
+			"movq %[quads], %%rcx\n\t"
+			"jrcxz 4f\n"
+			"3:\n\t"
+			"movq (%[a]), %[t0]\n\t"
+			"movq 8(%[a]), %[t1]\n\t"
+			"sbbq (%[b]), %[t0]\n\t"
+			"sbbq 8(%[b]), %[t1]\n\t"
+			"movq %[t0], (%[r])\n\t"
+			"movq %[t1], 8(%[r])\n\t"
+			"movq 16(%[a]), %[t0]\n\t"
+			"movq 24(%[a]), %[t1]\n\t"
+			"sbbq 16(%[b]), %[t0]\n\t"
+			"sbbq 24(%[b]), %[t1]\n\t"
+			"movq %[t0], 16(%[r])\n\t"
+			"movq %[t1], 24(%[r])\n\t"
+			"leaq 32(%[a]), %[a]\n\t"
+			"leaq 32(%[b]), %[b]\n\t"
+			"leaq 32(%[r]), %[r]\n\t"
+			"decq %%rcx\n\t"
+			"jnz 3b\n"
+			"4:\n\t"
+			"setc %b[borrow]\n\t"
+			: [borrow] "=&r" (borrow), [t0] "=&r" (t0), [t1] "=&r" (t1), [r] "+r" (r), [a] "+r" (a), [b] "+r" (b),
+			  "+c" (count)
+			: [quads] "r" (n / 4)
+			: "cc", "memory"
+		);
+		return borrow;
+	}
+
+	/* Requires BMI2, the high half of each product joins the next low half through one adc chain */
+	static unit_type mul_1(unit_type* r, const unit_type* a, uint64_t n, unit_type b) {
+		uint64_t count = n % 4;
+		unit_type carry, low, high;
+		__asm__ volatile (
+			"xorl %k[carry], %k[carry]\n\t"
+			"jrcxz 2f\n"
+			"1:\n\t"
+			"mulxq (%[a]), %[low], %[high]\n\t"
+			"adcq %[carry], %[low]\n\t"
+			"movq %[low], (%[r])\n\t"
+			"movq %[high], %[carry]\n\t"
+			"leaq 8(%[a]), %[a]\n\t"
+			"leaq 8(%[r]), %[r]\n\t"
+			"decq %%rcx\n\t"
+			"jnz 1b\n"
+			"2:\n\t"
+			"movq %[quads], %%rcx\n\t"
+			"jrcxz 4f\n"
+			"3:\n\t"
+			"mulxq (%[a]), %[low], %[high]\n\t"
+			"adcq %[carry], %[low]\n\t"
+			"movq %[low], (%[r])\n\t"
+			"mulxq 8(%[a]), %[low], %[carry]\n\t"
+			"adcq %[high], %[low]\n\t"
+			"movq %[low], 8(%[r])\n\t"
+			"mulxq 16(%[a]), %[low], %[high]\n\t"
+			"adcq %[carry], %[low]\n\t"
+			"movq %[low], 16(%[r])\n\t"
+			"mulxq 24(%[a]), %[low], %[carry]\n\t"
+			"adcq %[high], %[low]\n\t"
+			"movq %[low], 24(%[r])\n\t"
+			"leaq 32(%[a]), %[a]\n\t"
+			"leaq 32(%[r]), %[r]\n\t"
+			"decq %%rcx\n\t"
+			"jnz 3b\n"
+			"4:\n\t"
+			"adcq $0, %[carry]\n\t"
+			: [carry] "=&r" (carry), [low] "=&r" (low), [high] "=&r" (high), [r] "+r" (r), [a] "+r" (a), "+c" (count)
+			: [quads] "r" (n / 4), "d" (b)
+			: "cc", "memory"
+		);
+		return carry;
+	}
+
+	/* Requires ADX and BMI2, adcx carries the high halves into the next limb and adox adds r on a second chain */
+	static unit_type addmul_1(unit_type* r, const unit_type* a, uint64_t n, unit_type b) {
+		uint64_t count = n % 4;
+		unit_type carry, low, high, zero;
+		__asm__ volatile (
+			"xorl %k[carry], %k[carry]\n\t"
+			"xorl %k[zero], %k[zero]\n\t"
+			"1:\n\t"
+			"jrcxz 2f\n\t"
+			"mulxq (%[a]), %[low], %[high]\n\t"
+			"adcxq %[carry], %[low]\n\t"
+			"adoxq (%[r]), %[low]\n\t"
+			"movq %[low], (%[r])\n\t"
+			"movq %[high], %[carry]\n\t"
+			"leaq 8(%[a]), %[a]\n\t"
+			"leaq 8(%[r]), %[r]\n\t"
+			"leaq -1(%%rcx), %%rcx\n\t"
+			"jmp 1b\n"
+			"2:\n\t"
+			"movq %[quads], %%rcx\n"
+			"3:\n\t"
+			"jrcxz 4f\n\t"
+			"mulxq (%[a]), %[low], %[high]\n\t"
+			"adcxq %[carry], %[low]\n\t"
+			"adoxq (%[r]), %[low]\n\t"
+			"movq %[low], (%[r])\n\t"
+			"mulxq 8(%[a]), %[low], %[carry]\n\t"
+			"adcxq %[high], %[low]\n\t"
+			"adoxq 8(%[r]), %[low]\n\t"
+			"movq %[low], 8(%[r])\n\t"
+			"mulxq 16(%[a]), %[low], %[high]\n\t"
+			"adcxq %[carry], %[low]\n\t"
+			"adoxq 16(%[r]), %[low]\n\t"
+			"movq %[low], 16(%[r])\n\t"
+			"mulxq 24(%[a]), %[low], %[carry]\n\t"
+			"adcxq %[high], %[low]\n\t"
+			"adoxq 24(%[r]), %[low]\n\t"
+			"movq %[low], 24(%[r])\n\t"
+			"leaq 32(%[a]), %[a]\n\t"
+			"leaq 32(%[r]), %[r]\n\t"
+			"leaq -1(%%rcx), %%rcx\n\t"
+			"jmp 3b\n"
+			"4:\n\t"
+			"adcxq %[zero], %[carry]\n\t"
+			"adoxq %[zero], %[carry]\n\t"
+			: [carry] "=&r" (carry), [low] "=&r" (low), [high] "=&r" (high), [zero] "=&r" (zero), [r] "+r" (r),
+			  [a] "+r" (a), "+c" (count)
+			: [quads] "r" (n / 4), "d" (b)
+			: "cc", "memory"
+		);
+		return carry;
+	}
+
+	/* Requires BMI2, the borrow of each limb goes into the high half of its product */
+	static unit_type submul_1(unit_type* r, const unit_type* a, uint64_t n, unit_type b) {
+		unit_type borrow, low, high;
+		__asm__ volatile (
+			"xorl %k[borrow], %k[borrow]\n\t"
+			"jrcxz 2f\n"
+			"1:\n\t"
+			"mulxq (%[a]), %[low], %[high]\n\t"
+			"addq %[borrow], %[low]\n\t"
+			"adcq $0, %[high]\n\t"
+			"subq %[low], (%[r])\n\t"
+			"adcq $0, %[high]\n\t"
+			"movq %[high], %[borrow]\n\t"
+			"leaq 8(%[a]), %[a]\n\t"
+			"leaq 8(%[r]), %[r]\n\t"
+			"decq %%rcx\n\t"
+			"jnz 1b\n"
+			"2:\n\t"
+			: [borrow] "=&r" (borrow), [low] "=&r" (low), [high] "=&r" (high), [r] "+r" (r), [a] "+r" (a), "+c" (n)
+			: "d" (b)
+			: "cc", "memory"
+		);
+		return borrow;
+	}
+
+	/* Set bits of n limbs, the baseline x86-64 has no popcnt instruction so it is only enabled for this loop */
+	__attribute__((target("popcnt")))
+	static uint64_t popcount(const unit_type* a, uint64_t n) {
+		uint64_t count = 0;
+		for (uint64_t i = 0; i < n; i++) {
+			count += static_cast<uint64_t>(__builtin_popcountll(a[i]));
+		}
+		return count;
+	}
+
+	/*
+	 * Operand sizes in limbs the IFMA product is worth it for. Below the minimum the digit conversion costs more than the
+	 * vector multiply saves, the digit buffers for the maximum live on the stack.
+	 */
+	static constexpr uint64_t ifma_min_size = 32;
+	static constexpr uint64_t ifma_max_size = 64;
+
+	/*
+	 * Product in radix 2^52 with AVX-512 IFMA, requires an >= bn and an <= ifma_max_size. Each lane of a vector sums
+	 * the low and high halves of the digit products landing in one column of the result, a carry pass then packs the
+	 * columns back into limbs.
+	 */
+	__attribute__((target("avx512f,avx512ifma")))
+	static void mul_ifma(unit_type* r, const unit_type* a, uint64_t an, const unit_type* b, uint64_t bn) {
+		constexpr uint64_t max_digits = (ifma_max_size * 64 + 51) / 52;
+		uint64_t ad = (an * 64 + 51) / 52;
+		uint64_t bd = (bn * 64 + 51) / 52;
+		uint64_t columns = (ad + bd + 7) / 8 * 8;
+
+		/* The vector loads read the digits of a from bd + 1 before its start to bd + 15 past its end, all zero */
+		alignas(64) std::array<unit_type, 3 * max_digits + 16> padded;
+		alignas(64) std::array<unit_type, max_digits> b_digits;
+		alignas(64) std::array<unit_type, 2 * max_digits + 8> sums;
+		unit_type* a_digits = padded.data() + bd + 1;
+		std::fill(padded.data(), a_digits, 0);
+		LimbKernelsX86::to_digits(a_digits, a, an, ad);
+		std::fill(a_digits + ad, a_digits + ad + bd + 15, 0);
+		LimbKernelsX86::to_digits(b_digits.data(), b, bn, bd);
+
+		for (uint64_t k = 0; k < columns; k += 8) {
+			__m512i low0 = _mm512_setzero_si512(), low1 = _mm512_setzero_si512();
+			__m512i high0 = _mm512_setzero_si512(), high1 = _mm512_setzero_si512();
+			/* Only the digits of b whose products reach one of the eight columns */
+			uint64_t j = k > ad ? k - ad : 0;
+			uint64_t end = std::min(bd, k + 8);
+			for (; j + 1 < end; j += 2) {
+				__m512i first = _mm512_set1_epi64(static_cast<int64_t>(b_digits[j]));
+				__m512i second = _mm512_set1_epi64(static_cast<int64_t>(b_digits[j + 1]));
+				low0 = _mm512_madd52lo_epu64(low0, _mm512_loadu_si512(a_digits + k - j), first);
+				high0 = _mm512_madd52hi_epu64(high0, _mm512_loadu_si512(a_digits + k - j - 1), first);
+				low1 = _mm512_madd52lo_epu64(low1, _mm512_loadu_si512(a_digits + k - j - 1), second);
+				high1 = _mm512_madd52hi_epu64(high1, _mm512_loadu_si512(a_digits + k - j - 2), second);
+			}
+			if (j < end) {
+				__m512i first = _mm512_set1_epi64(static_cast<int64_t>(b_digits[j]));
+				low0 = _mm512_madd52lo_epu64(low0, _mm512_loadu_si512(a_digits + k - j), first);
+				high0 = _mm512_madd52hi_epu64(high0, _mm512_loadu_si512(a_digits + k - j - 1), first);
+			}
+			__m512i sum = _mm512_add_epi64(_mm512_add_epi64(low0, low1), _mm512_add_epi64(high0, high1));
+			_mm512_storeu_si512(sums.data() + k, sum);
+		}
+
+		/* Columns hold sums below 2^(52 + 2 + log2 bd), the carry pass keeps 52 bits of each */
+		next_type window = 0;
+		unit_type carry = 0;
+		uint64_t filled = 0, index = 0;
+		for (uint64_t k = 0; k < ad + bd && index < an + bn; k++) {
+			unit_type column = sums[k] + carry;
+			carry = column >> 52;
+			window |= static_cast<next_type>(column & digit_mask) << filled;
+			filled += 52;
+			if (filled >= 64) {
+				r[index++] = static_cast<unit_type>(window);
+				window >>= 64;
+				filled -= 64;
+			}
+		}
+		for (; index < an + bn; index++) {
+			r[index] = static_cast<unit_type>(window);
+			window >>= 64;
+		}
+	}
+
+private:
+
+	static constexpr unit_type digit_mask = (static_cast<unit_type>(1) << 52) - 1;
+
+	/* Splits n limbs into count digits of 52 bits */
+	static void to_digits(unit_type* digits, const unit_type* a, uint64_t n, uint64_t count) {
+		for (uint64_t d = 0; d < count; d++) {
+			uint64_t bit = d * 52;
+			uint64_t index = bit / 64;
+			uint64_t offset = bit % 64;
+			unit_type value = a[index] >> offset;
+			if (offset > 12 && index + 1 < n) {
+				value |= a[index + 1] << (64 - offset);
+			}
+			digits[d] = value & digit_mask;
+		}
+	}
+};
+
+#endif
@@ -0,0 +1,115 @@
+#pragma once
+
+#include <bit>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+#include <memory_resource>
+
+/*
+ * Size class resource for long running work with many short lived numbers. Requests are rounded up to a power of two
+ * number of limbs, matching the geometric growth of limb buffers, and recycled through one free list per class. Blocks
+ * are carved from chunks obtained upstream, requests above the largest class go upstream directly.
+ */
+class LimbPool : public std::pmr::memory_resource {
+private:
+
+	struct Chunk {
+		Chunk* previous;
+		std::size_t size;
+	};
+
+	struct Block {
+		Block* next;
+	};
+
+	static constexpr std::size_t smallest_block = 32;
+	static constexpr std::size_t classes = 16;
+	static constexpr std::size_t largest_block = smallest_block << (classes - 1);
+	static constexpr std::size_t chunk_size = 64 * 1024;
+	static constexpr std::size_t block_alignment = alignof(std::max_align_t);
+
+	std::pmr::memory_resource* upstream_;
+	std::array<Block*, classes> free_ = {};
+	Chunk* chunks_ = nullptr;
+
+	static constexpr std::size_t size_class(std::size_t bytes) {
+		bytes = std::max(bytes, smallest_block);
+		return static_cast<std::size_t>(std::bit_width(bytes - 1) - std::bit_width(smallest_block - 1));
+	}
+
+	/* Splits a new chunk into blocks of the class, at least one */
+	void refill(std::size_t index) {
+		std::size_t block_size = smallest_block << index;
+		std::size_t size = sizeof(Chunk) + block_alignment + std::max(chunk_size, block_size);
+		auto* chunk = static_cast<Chunk*>(upstream_->allocate(size, block_alignment));
+		chunk->previous = chunks_;
+		chunk->size = size;
+		chunks_ = chunk;
+
+		std::byte* first = reinterpret_cast<std::byte*>(chunk) + block_alignment;
+		std::byte* last = reinterpret_cast<std::byte*>(chunk) + size;
+		for (std::byte* block = first; last - block >= static_cast<std::ptrdiff_t>(block_size); block += block_size) {
+			auto* free_block = reinterpret_cast<Block*>(block);
+			free_block->next = free_[index];
+			free_[index] = free_block;
+		}
+	}
+
+	void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+		if (bytes > largest_block || alignment > block_alignment) {
+			return upstream_->allocate(bytes, alignment);
+		}
+
+		std::size_t index = LimbPool::size_class(bytes);
+		if (free_[index] == nullptr) {
+			this->refill(index);
+		}
+
+		Block* block = free_[index];
+		free_[index] = block->next;
+		return block;
+	}
+
+	void do_deallocate(void* pointer, std::size_t bytes, std::size_t alignment) override {
+		if (bytes > largest_block || alignment > block_alignment) {
+			upstream_->deallocate(pointer, bytes, alignment);
+			return;
+		}
+
+		std::size_t index = LimbPool::size_class(bytes);
+		auto* block = static_cast<Block*>(pointer);
+		block->next = free_[index];
+		free_[index] = block;
+	}
+
+	[[nodiscard]] bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+		return this == &other;
+	}
+
+public:
+
+	explicit LimbPool(std::pmr::memory_resource* upstream = std::pmr::new_delete_resource()) : upstream_(upstream) {}
+
+	LimbPool(const LimbPool&) = delete;
+	LimbPool& operator=(const LimbPool&) = delete;
+
+	~LimbPool() override {
+		this->release();
+	}
+
+	/* Returns every chunk upstream, numbers still using the pool are left dangling */
+	void release() {
+		while (chunks_ != nullptr) {
+			Chunk* previous = chunks_->previous;
+			upstream_->deallocate(chunks_, chunks_->size, block_alignment);
+			chunks_ = previous;
+		}
+		free_.fill(nullptr);
+	}
+
+	[[nodiscard]] std::pmr::memory_resource* upstream_resource() const {
+		return upstream_;
+	}
+};
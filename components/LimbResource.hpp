@@ -0,0 +1,36 @@
+#pragma once
+
+#include <utility>
+#include <memory_resource>
+
+/* Memory resource that limb buffers created on the current thread allocate from, null for the global heap */
+class LimbResource {
+private:
+
+	static std::pmr::memory_resource*& slot() {
+		thread_local std::pmr::memory_resource* resource = nullptr;
+		return resource;
+	}
+
+public:
+
+	static std::pmr::memory_resource* current() {
+		return LimbResource::slot();
+	}
+
+	/* Makes a resource current for the lifetime of the scope, numbers created inside must not outlive the resource */
+	class Scope {
+	private:
+		std::pmr::memory_resource* previous_;
+
+	public:
+		explicit Scope(std::pmr::memory_resource& resource) : previous_(std::exchange(LimbResource::slot(), &resource)) {}
+
+		Scope(const Scope&) = delete;
+		Scope& operator=(const Scope&) = delete;
+
+		~Scope() {
+			LimbResource::slot() = previous_;
+		}
+	};
+};
@@ -0,0 +1,321 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <cstdint>
+#include <utility>
+#include <iterator>
+#include <algorithm>
+
+#include <LimbKernels.hpp>
+#include <LimbAllocator.hpp>
+
+/*
+ * Limb buffer holding up to N limbs inline and spilling to the heap past that, heap capacity grows geometrically.
+ * Heap buffers come from the resource current when the storage was constructed. Copies share heap buffers of at least
+ * share_threshold limbs when they allocate from the same resource, the limb after the capacity counts its owners
+ * atomically so copies may live on different threads. The first non const access to a shared buffer copies it, so
+ * copying a large number is O(1) and only mutation pays.
+ */
+template<uint64_t N>
+class LimbStorage {
+public:
+	using unit_type = LimbKernels::unit_type;
+	using value_type = unit_type;
+	using iterator = unit_type*;
+	using const_iterator = const unit_type*;
+	using reverse_iterator = std::reverse_iterator<iterator>;
+	using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+	static constexpr uint64_t inline_capacity = N;
+
+	/* Smaller buffers are cheaper to copy than to count, and their accessors skip the atomic owner count */
+	static constexpr uint64_t share_threshold = 32;
+
+private:
+
+	uint64_t size_ = 0;
+	uint64_t capacity_ = N;
+	LimbAllocator<unit_type> allocator_;
+	union {
+		unit_type inline_[N] = {};
+		unit_type* heap_;
+	};
+
+	[[nodiscard]] constexpr bool is_inline() const {
+		return capacity_ == N;
+	}
+
+	[[nodiscard]] constexpr bool is_shareable() const {
+		return !this->is_inline() && capacity_ >= share_threshold;
+	}
+
+	[[nodiscard]] constexpr bool is_shared() const {
+		if (!this->is_shareable()) {
+			return false;
+		}
+
+		if consteval {
+			return heap_[capacity_] > 1;
+		} else {
+			/* Acquire pairs with the release of the last other owner, whose reads of the buffer precede our writes */
+			return std::atomic_ref<unit_type>(heap_[capacity_]).load(std::memory_order_acquire) > 1;
+		}
+	}
+
+	/* Removes an owner of a shareable buffer, true for the last one, which skips the atomic decrement since nobody can copy it meanwhile */
+	constexpr bool drop_owner() {
+		if consteval {
+			return --heap_[capacity_] == 0;
+		} else {
+			std::atomic_ref<unit_type> owners(heap_[capacity_]);
+			return owners.load(std::memory_order_acquire) == 1 || owners.fetch_sub(1, std::memory_order_acq_rel) == 1;
+		}
+	}
+
+	constexpr void release() {
+		if (this->is_inline() || (this->is_shareable() && !this->drop_owner())) {
+			return;
+		}
+		allocator_.deallocate(heap_, capacity_ + this->is_shareable());
+	}
+
+	/* Joins the owners of the heap buffer of other */
+	constexpr void share(const LimbStorage& other) {
+		if consteval {
+			other.heap_[other.capacity_] += 1;
+		} else {
+			std::atomic_ref<unit_type>(other.heap_[other.capacity_]).fetch_add(1, std::memory_order_relaxed);
+		}
+		heap_ = other.heap_;
+		capacity_ = other.capacity_;
+		size_ = other.size_;
+	}
+
+	[[nodiscard]] constexpr bool can_share(const LimbStorage& other) const {
+		return other.is_shareable() && allocator_ == other.allocator_;
+	}
+
+	/* Limbs without unsharing */
+	[[nodiscard]] constexpr unit_type* buffer() const {
+		return this->is_inline() ? const_cast<unit_type*>(inline_) : heap_;
+	}
+
+	/* Moves the limbs to a heap buffer of its own with the given capacity, kept out of line to keep the accessors small */
+	[[gnu::noinline]] constexpr void reallocate(uint64_t capacity) {
+		bool shareable = capacity >= share_threshold;
+		unit_type* buffer = allocator_.allocate(capacity + shareable);
+		if (shareable) {
+			buffer[capacity] = 1;
+		}
+		LimbKernels::copy(buffer, this->buffer(), size_);
+		this->release();
+		heap_ = buffer;
+		capacity_ = capacity;
+	}
+
+	/* Empties the storage, a shared buffer is left to its other owners instead of being copied */
+	constexpr void discard() {
+		if (this->is_shared()) {
+			this->release();
+			capacity_ = N;
+			inline_[0] = 0;
+		}
+		size_ = 0;
+	}
+
+	/* Copies a shared buffer to one of its own with room for at least the given capacity */
+	constexpr void unshare(uint64_t capacity) {
+		if (this->is_shared()) {
+			this->reallocate(std::max({capacity, size_, 2 * N}));
+		}
+	}
+
+	/* Moves the limbs to a heap buffer of at least the requested capacity */
+	constexpr void grow(uint64_t capacity) {
+		this->reallocate(std::max(capacity, 2 * capacity_));
+	}
+
+	/* Leaves other empty and inline, a heap buffer must come from the same resource */
+	constexpr void steal(LimbStorage& other) noexcept {
+		if (other.is_inline()) {
+			LimbKernels::copy(inline_, other.inline_, other.size_);
+		} else {
+			heap_ = other.heap_;
+			capacity_ = other.capacity_;
+			other.capacity_ = N;
+			other.inline_[0] = 0;
+		}
+		size_ = other.size_;
+		other.size_ = 0;
+	}
+
+public:
+
+	constexpr LimbStorage() = default;
+
+	constexpr LimbStorage(const LimbStorage& other) {
+		if (this->can_share(other)) {
+			this->share(other);
+		} else {
+			this->assign(other.begin(), other.end());
+		}
+	}
+
+	constexpr LimbStorage(LimbStorage&& other) noexcept : allocator_(other.allocator_) {
+		this->steal(other);
+	}
+
+	/* A heap buffer of its own that fits the limbs is reused rather than shared, it is likely to be written again */
+	constexpr LimbStorage& operator=(const LimbStorage& other) {
+		if (this == &other) {
+			return *this;
+		}
+
+		if (this->can_share(other) && (this->is_inline() || capacity_ < other.size_ || this->is_shared())) {
+			this->release();
+			this->share(other);
+		} else {
+			this->assign(other.begin(), other.end());
+		}
+		return *this;
+	}
+
+	/* Buffers from another resource are copied so that the storage keeps to its own */
+	constexpr LimbStorage& operator=(LimbStorage&& other) {
+		if (this == &other) {
+			return *this;
+		}
+
+		if (!other.is_inline() && allocator_ != other.allocator_) {
+			this->assign(std::as_const(other).begin(), std::as_const(other).end());
+			other.clear();
+		} else {
+			this->release();
+			capacity_ = N;
+			inline_[0] = 0;
+			this->steal(other);
+		}
+		return *this;
+	}
+
+	constexpr ~LimbStorage() {
+		this->release();
+	}
+
+	[[nodiscard]] constexpr uint64_t size() const {
+		return size_;
+	}
+
+	[[nodiscard]] constexpr uint64_t capacity() const {
+		return capacity_;
+	}
+
+	[[nodiscard]] constexpr bool empty() const {
+		return size_ == 0;
+	}
+
+	/* Copies a shared buffer first */
+	[[nodiscard]] constexpr unit_type* data() {
+		this->unshare(size_);
+		return this->buffer();
+	}
+
+	[[nodiscard]] constexpr const unit_type* data() const {
+		return this->buffer();
+	}
+
+	constexpr unit_type& operator[](uint64_t index) {
+		return this->data()[index];
+	}
+
+	constexpr const unit_type& operator[](uint64_t index) const {
+		return this->data()[index];
+	}
+
+	constexpr unit_type& front() {
+		return this->data()[0];
+	}
+
+	[[nodiscard]] constexpr const unit_type& front() const {
+		return this->data()[0];
+	}
+
+	constexpr unit_type& back() {
+		return this->data()[size_ - 1];
+	}
+
+	[[nodiscard]] constexpr const unit_type& back() const {
+		return this->data()[size_ - 1];
+	}
+
+	constexpr iterator begin() {
+		return this->data();
+	}
+
+	constexpr iterator end() {
+		return this->data() + size_;
+	}
+
+	[[nodiscard]] constexpr const_iterator begin() const {
+		return this->data();
+	}
+
+	[[nodiscard]] constexpr const_iterator end() const {
+		return this->data() + size_;
+	}
+
+	[[nodiscard]] constexpr const_reverse_iterator rbegin() const {
+		return const_reverse_iterator(this->end());
+	}
+
+	[[nodiscard]] constexpr const_reverse_iterator rend() const {
+		return const_reverse_iterator(this->begin());
+	}
+
+	/* A shared buffer is copied first, its capacity belongs to the other owners */
+	constexpr void reserve(uint64_t capacity) {
+		this->unshare(capacity);
+		if (capacity > capacity_) {
+			this->grow(capacity);
+		}
+	}
+
+	/* New limbs are zero */
+	constexpr void resize(uint64_t size) {
+		this->reserve(size);
+		if (size > size_) {
+			LimbKernels::zero(this->data() + size_, size - size_);
+		}
+		size_ = size;
+	}
+
+	constexpr void assign(uint64_t size, unit_type value) {
+		this->discard();
+		this->reserve(size);
+		std::fill_n(this->buffer(), size, value);
+		size_ = size;
+	}
+
+	template<std::forward_iterator Iterator>
+	constexpr void assign(Iterator first, Iterator last) {
+		this->discard();
+		this->reserve(static_cast<uint64_t>(std::distance(first, last)));
+		size_ = static_cast<uint64_t>(std::copy(first, last, this->buffer()) - this->buffer());
+	}
+
+	constexpr void push_back(unit_type unit) {
+		this->reserve(size_ + 1);
+		this->data()[size_] = unit;
+		size_ += 1;
+	}
+
+	constexpr void clear() {
+		size_ = 0;
+	}
+
+	friend constexpr bool operator==(const LimbStorage& first, const LimbStorage& second) {
+		return first.size_ == second.size_ &&
+			   (first.data() == second.data() || LimbKernels::compare_n(first.data(), second.data(), first.size_) == 0);
+	}
+};
@@ -0,0 +1,324 @@
+#pragma once
+
+#include <bit>
+#include <span>
+#include <array>
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+
+#include <ArithmeticException.hpp>
+#include <BigInteger.hpp>
+#include <LimbKernels.hpp>
+#include <LimbAllocator.hpp>
+#include <Multiplication.hpp>
+
+/*
+ * Arithmetic modulo a fixed positive modulus of n limbs, with Montgomery multiplication for odd moduli and Barrett
+ * reduction for even ones. Constants are computed once, intermediate values never exceed 2n + 2 limbs.
+ */
+class ModContext {
+public:
+	using unit_type = LimbKernels::unit_type;
+
+private:
+
+	/* Scratch of one computation, values in the internal form take n limbs */
+	struct Workspace {
+		limb_vector product;
+		limb_vector quotient;
+		limb_vector remainder;
+		limb_vector table;
+
+		explicit Workspace(uint64_t n) : product(2 * n + 2), quotient(2 * n + 2), remainder(2 * n + 2) {}
+	};
+
+	/* Exponent bit counts above which the sliding window grows by one bit */
+	static constexpr std::array<uint64_t, 7> window_thresholds = {7, 25, 81, 241, 673, 1793, 4609};
+
+	BigInteger modulus_;
+	uint64_t n_;
+	bool montgomery_;
+	unit_type inverse_ = 0;
+	limb_vector square_;
+	limb_vector reciprocal_;
+
+	[[nodiscard]] const unit_type* modulus_limbs() const {
+		return modulus_.integer_storage().data();
+	}
+
+	/* -m^-1 mod B by Newton's iteration, each step doubles the number of correct low bits starting from 3 */
+	static constexpr unit_type negated_inverse(unit_type m) {
+		unit_type inverse = m;
+		for (int32_t i = 0; i < 5; i++) {
+			inverse *= 2 - m * inverse;
+		}
+		return 0 - inverse;
+	}
+
+	/* Montgomery reduction of the 2n limbs of the product, r = product / B^n mod m */
+	void redc(unit_type* r, Workspace& workspace) const {
+		unit_type* t = workspace.product.data();
+		const unit_type* m = this->modulus_limbs();
+		unit_type high = 0;
+
+		for (uint64_t i = 0; i < n_; i++) {
+			unit_type carry = LimbKernels::addmul_1(t + i, m, n_, t[i] * inverse_);
+			unit_type sum = t[i + n_] + carry;
+			carry = sum < carry;
+			sum += high;
+			carry += sum < high;
+			t[i + n_] = sum;
+			high = carry;
+		}
+
+		if (high != 0 || LimbKernels::compare_n(t + n_, m, n_) >= 0) {
+			LimbKernels::sub_n(r, t + n_, m, n_);
+		} else {
+			LimbKernels::copy(r, t + n_, n_);
+		}
+	}
+
+	/* Barrett reduction of the 2n limbs of the product, the quotient estimate is at most three below the true one */
+	void barrett(unit_type* r, Workspace& workspace) const {
+		unit_type* x = workspace.product.data();
+		const unit_type* m = this->modulus_limbs();
+
+		Multiplication::mul(workspace.quotient.data(), x + n_ - 1, n_ + 1, reciprocal_.data(), n_ + 1);
+		Multiplication::mul(workspace.remainder.data(), workspace.quotient.data() + n_ + 1, n_ + 1, m, n_);
+		LimbKernels::sub_n(x, x, workspace.remainder.data(), n_ + 1);
+
+		while (x[n_] != 0 || LimbKernels::compare_n(x, m, n_) >= 0) {
+			x[n_] -= LimbKernels::sub_n(x, x, m, n_);
+		}
+		LimbKernels::copy(r, x, n_);
+	}
+
+	/* r = a * b in the internal form, passing the same pointer twice squares, r may alias the operands */
+	void multiply(unit_type* r, const unit_type* a, const unit_type* b, Workspace& workspace) const {
+		Multiplication::mul(workspace.product.data(), a, n_, b, n_);
+		if (montgomery_) {
+			this->redc(r, workspace);
+		} else {
+			this->barrett(r, workspace);
+		}
+	}
+
+	/* Writes the residue of x in [0, m) to the n limbs of r, without converting it to the internal form */
+	void residue(unit_type* r, const BigInteger& x) const {
+		const BigInteger* value = &x;
+		BigInteger reduced;
+		if (x.state().is_negative || x >= modulus_) {
+			reduced = x % modulus_;
+			if (reduced.state().is_negative) {
+				reduced += modulus_;
+			}
+			value = &reduced;
+		}
+
+		const auto& limbs = value->integer_storage();
+		LimbKernels::copy(r, limbs.data(), limbs.size());
+		LimbKernels::zero(r + limbs.size(), n_ - limbs.size());
+	}
+
+	void load(unit_type* r, const BigInteger& x, Workspace& workspace) const {
+		this->residue(r, x);
+		if (montgomery_) {
+			this->multiply(r, r, square_.data(), workspace);
+		}
+	}
+
+	[[nodiscard]] BigInteger store(const unit_type* a, Workspace& workspace) const {
+		BigInteger result;
+		auto& limbs = result.integer_storage();
+		limbs.resize(n_);
+		if (montgomery_) {
+			LimbKernels::copy(workspace.product.data(), a, n_);
+			LimbKernels::zero(workspace.product.data() + n_, n_);
+			this->redc(limbs.data(), workspace);
+		} else {
+			LimbKernels::copy(limbs.data(), a, n_);
+		}
+		result.normalize();
+		return result;
+	}
+
+	/* Product of two residues as a plain residue, Montgomery multiplies by B^2n to cancel the two divisions by B^n */
+	[[nodiscard]] BigInteger multiply_residues(const BigInteger& a, const BigInteger& b) const {
+		Workspace workspace(n_);
+		limb_vector first(n_), second(n_);
+		this->residue(first.data(), a);
+		this->residue(second.data(), b);
+		this->multiply(first.data(), first.data(), &a == &b ? first.data() : second.data(), workspace);
+		if (montgomery_) {
+			this->multiply(first.data(), first.data(), square_.data(), workspace);
+		}
+
+		BigInteger result;
+		result.integer_storage().assign(first.begin(), first.end());
+		result.normalize();
+		return result;
+	}
+
+	static constexpr bool bit(const BigInteger& number, uint64_t index) {
+		return ((number.integer_storage()[index / LimbKernels::unit_bits] >> (index % LimbKernels::unit_bits)) & 1U) != 0;
+	}
+
+	/* Left to right sliding window exponentiation over the odd powers of the base, r must not alias base */
+	void power(unit_type* r, const unit_type* base, const BigInteger& exponent, Workspace& workspace) const {
+		const auto& limbs = exponent.integer_storage();
+		uint64_t bits = limbs.empty() ? 0 : limbs.size() * LimbKernels::unit_bits - static_cast<uint64_t>(std::countl_zero(limbs.back()));
+		if (bits == 0) {
+			this->load(r, BigInteger::ONE(), workspace);
+			return;
+		}
+
+		uint64_t window = 1 + static_cast<uint64_t>(std::count_if(window_thresholds.begin(), window_thresholds.end(),
+																  [bits](uint64_t threshold) { return bits > threshold; }));
+		uint64_t entries = uint64_t(1) << (window - 1);
+		limb_vector& table = workspace.table;
+		table.resize(entries * n_);
+		LimbKernels::copy(table.data(), base, n_);
+		if (entries > 1) {
+			this->multiply(r, base, base, workspace);
+			for (uint64_t i = 1; i < entries; i++) {
+				this->multiply(table.data() + i * n_, table.data() + (i - 1) * n_, r, workspace);
+			}
+		}
+
+		bool started = false;
+		for (uint64_t i = bits; i > 0;) {
+			if (!ModContext::bit(exponent, i - 1)) {
+				this->multiply(r, r, r, workspace);
+				i -= 1;
+				continue;
+			}
+
+			uint64_t low = i > window ? i - window : 0;
+			while (!ModContext::bit(exponent, low)) {
+				low += 1;
+			}
+
+			uint64_t value = 0;
+			for (uint64_t j = i; j > low; j--) {
+				value = (value << 1) | static_cast<uint64_t>(ModContext::bit(exponent, j - 1));
+			}
+
+			const unit_type* entry = table.data() + (value >> 1) * n_;
+			if (started) {
+				for (uint64_t j = low; j < i; j++) {
+					this->multiply(r, r, r, workspace);
+				}
+				this->multiply(r, r, entry, workspace);
+			} else {
+				LimbKernels::copy(r, entry, n_);
+				started = true;
+			}
+			i = low;
+		}
+	}
+
+	static void check_exponent(const BigInteger& exponent) {
+		if (exponent.state().is_negative) {
+			throw ArithmeticException("Exponent must be non negative.");
+		}
+	}
+
+public:
+
+	explicit ModContext(const BigInteger& modulus) : modulus_(modulus) {
+		if (modulus <= 0) {
+			throw ArithmeticException("Modulus must be positive.");
+		}
+
+		n_ = modulus_.integer_storage().size();
+		montgomery_ = (modulus_.integer_storage().front() & 1U) != 0;
+		BigInteger power = BigInteger::ONE() << (2 * n_ * LimbKernels::unit_bits);
+
+		if (montgomery_) {
+			inverse_ = ModContext::negated_inverse(modulus_.integer_storage().front());
+			square_.resize(n_);
+			this->residue(square_.data(), power);
+		} else {
+			/* B^(2n) / m is B^(n+1) for m = B^(n-1), one limb too many, and B^(n+1) - 1 only costs the estimate one step */
+			BigInteger reciprocal = power / modulus_;
+			if (reciprocal.integer_storage().size() > n_ + 1) {
+				reciprocal_.assign(n_ + 1, ~static_cast<unit_type>(0));
+			} else {
+				reciprocal_.assign(n_ + 1, 0);
+				std::copy(reciprocal.integer_storage().begin(), reciprocal.integer_storage().end(), reciprocal_.begin());
+			}
+		}
+	}
+
+	[[nodiscard]] const BigInteger& modulus() const {
+		return modulus_;
+	}
+
+	[[nodiscard]] bool is_montgomery() const {
+		return montgomery_;
+	}
+
+	/* Residue of x in [0, modulus) */
+	[[nodiscard]] BigInteger reduce(const BigInteger& x) const {
+		BigInteger result;
+		result.integer_storage().resize(n_);
+		this->residue(result.integer_storage().data(), x);
+		result.normalize();
+		return result;
+	}
+
+	[[nodiscard]] BigInteger mulmod(const BigInteger& a, const BigInteger& b) const {
+		return this->multiply_residues(a, b);
+	}
+
+	[[nodiscard]] BigInteger sqrmod(const BigInteger& a) const {
+		return this->multiply_residues(a, a);
+	}
+
+	/* base^exponent mod modulus for a non negative exponent */
+	[[nodiscard]] BigInteger powmod(const BigInteger& base, const BigInteger& exponent) const {
+		ModContext::check_exponent(exponent);
+		Workspace workspace(n_);
+		limb_vector value(n_), result(n_);
+		this->load(value.data(), base, workspace);
+		this->power(result.data(), value.data(), exponent, workspace);
+		return this->store(result.data(), workspace);
+	}
+
+	/* Raises every base to the same exponent, sharing the scratch between them */
+	[[nodiscard]] std::vector<BigInteger> powmod(std::span<const BigInteger> bases, const BigInteger& exponent) const {
+		ModContext::check_exponent(exponent);
+		Workspace workspace(n_);
+		limb_vector value(n_), result(n_);
+		std::vector<BigInteger> results;
+		results.reserve(bases.size());
+
+		for (const BigInteger& base : bases) {
+			this->load(value.data(), base, workspace);
+			this->power(result.data(), value.data(), exponent, workspace);
+			results.push_back(this->store(result.data(), workspace));
+		}
+		return results;
+	}
+
+	/* Raises each base to the exponent at the same position */
+	[[nodiscard]] std::vector<BigInteger> powmod(std::span<const BigInteger> bases, std::span<const BigInteger> exponents) const {
+		if (bases.size() != exponents.size()) {
+			throw ArithmeticException("Every base needs an exponent.");
+		}
+
+		std::for_each(exponents.begin(), exponents.end(), ModContext::check_exponent);
+		Workspace workspace(n_);
+		limb_vector value(n_), result(n_);
+		std::vector<BigInteger> results;
+		results.reserve(bases.size());
+
+		for (uint64_t i = 0; i < bases.size(); i++) {
+			this->load(value.data(), bases[i], workspace);
+			this->power(result.data(), value.data(), exponents[i], workspace);
+			results.push_back(this->store(result.data(), workspace));
+		}
+		return results;
+	}
+};
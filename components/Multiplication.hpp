@@ -0,0 +1,348 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+
+#include <Instrumentation.hpp>
+#include <LimbKernels.hpp>
+#include <LimbAllocator.hpp>
+#include <NumberTheoreticTransform.hpp>
+#include <ThreadPool.hpp>
+
+class Multiplication {
+public:
+	using unit_type = LimbKernels::unit_type;
+	using next_type = LimbKernels::next_type;
+
+	static constexpr uint64_t karatsuba_threshold = 16;
+	static constexpr uint64_t toom3_threshold = 128;
+	static constexpr uint64_t ntt_threshold = 5000;
+
+	/* Operand size in limbs below which the parallel multiplication stays on the calling thread */
+	static constexpr uint64_t parallel_threshold = 1024;
+
+private:
+
+	/* Stores |x - y| in r (xn limbs) and returns whether x < y, requires xn >= yn */
+	static constexpr bool abs_diff(unit_type* r, const unit_type* x, uint64_t xn, const unit_type* y, uint64_t yn) {
+		if (LimbKernels::normalized_size(x + yn, xn - yn) == 0 && LimbKernels::compare_n(x, y, yn) < 0) {
+			LimbKernels::sub_n(r, y, x, yn);
+			LimbKernels::zero(r + yn, xn - yn);
+			return true;
+		}
+
+		LimbKernels::sub(r, x, xn, y, yn);
+		return false;
+	}
+
+	/* Adds c into r, the part of c above rn limbs must be zero */
+	static constexpr void add_into(unit_type* r, uint64_t rn, const unit_type* c, uint64_t cn) {
+		cn = std::min(cn, rn);
+		LimbKernels::add(r, r, rn, c, cn);
+	}
+
+	/* Exact division by 3 using the inverse of 3 modulo 2^64 */
+	static constexpr void divexact_by3(unit_type* r, const unit_type* a, uint64_t n) {
+		constexpr unit_type inverse = 0xAAAAAAAAAAAAAAABULL;
+		unit_type carry = 0;
+		for (uint64_t i = 0; i < n; i++) {
+			unit_type borrow = a[i] < carry;
+			unit_type quotient = (a[i] - carry) * inverse;
+			r[i] = quotient;
+			carry = static_cast<unit_type>((static_cast<next_type>(quotient) * 3) >> LimbKernels::unit_bits) + borrow;
+		}
+	}
+
+	static constexpr void karatsuba_n(unit_type* r, const unit_type* a, const unit_type* b, uint64_t n, unit_type* scratch) {
+		BIGNUMBER_INSTRUMENT(karatsuba, n);
+		uint64_t high = n / 2;
+		uint64_t low = n - high;
+		unit_type* a_diff = scratch;
+		unit_type* b_diff = scratch + low;
+		unit_type* middle = scratch + 2 * low;
+		unit_type* next_scratch = scratch + 4 * low;
+
+		bool negative = false;
+		if (a == b) {
+			Multiplication::abs_diff(a_diff, a, low, a + low, high);
+			b_diff = a_diff;
+		} else {
+			negative = Multiplication::abs_diff(a_diff, a, low, a + low, high) !=
+					   Multiplication::abs_diff(b_diff, b, low, b + low, high);
+		}
+
+		Multiplication::mul_n(middle, a_diff, b_diff, low, next_scratch);
+		Multiplication::mul_n(r, a, b, low, next_scratch);
+		Multiplication::mul_n(r + 2 * low, a + low, b + low, high, next_scratch);
+
+		/* a0 * b1 + a1 * b0 = a0 * b0 + a1 * b1 - (a0 - a1) * (b0 - b1) */
+		unit_type* sum = scratch;
+		unit_type carry = LimbKernels::add(sum, r, 2 * low, r + 2 * low, 2 * high);
+		if (negative) {
+			carry += LimbKernels::add_n(sum, sum, middle, 2 * low);
+		} else {
+			carry -= LimbKernels::sub_n(sum, sum, middle, 2 * low);
+		}
+
+		carry += LimbKernels::add_n(r + low, r + low, sum, 2 * low);
+		LimbKernels::add_1(r + 3 * low, r + 3 * low, 2 * n - 3 * low, carry);
+	}
+
+	/* Evaluates x at 1, -1 and 2 into k + 1 limbs each, returns whether x(-1) is negative */
+	static constexpr bool toom3_evaluate(unit_type* at_one, unit_type* at_minus_one, unit_type* at_two,
+										 const unit_type* x, uint64_t k, uint64_t high) {
+		at_one[k] = LimbKernels::add(at_one, x, k, x + 2 * k, high);
+		bool negative = Multiplication::abs_diff(at_minus_one, at_one, k + 1, x + k, k);
+		at_one[k] += LimbKernels::add_n(at_one, at_one, x + k, k);
+
+		at_two[k] = at_one[k] + LimbKernels::add(at_two, at_one, k, x + 2 * k, high);
+		LimbKernels::lshift(at_two, at_two, k + 1, 1);
+		LimbKernels::sub(at_two, at_two, k + 1, x, k);
+		return negative;
+	}
+
+	static constexpr void toom3_n(unit_type* r, const unit_type* a, const unit_type* b, uint64_t n, unit_type* scratch,
+								  ThreadPool* pool) {
+		BIGNUMBER_INSTRUMENT(toom3, n);
+		uint64_t k = (n + 2) / 3;
+		uint64_t high = n - 2 * k;
+		uint64_t m = 2 * k + 2;
+		unit_type* a1 = scratch;
+		unit_type* am1 = a1 + (k + 1);
+		unit_type* a2 = am1 + (k + 1);
+		unit_type* b1 = a2 + (k + 1);
+		unit_type* bm1 = b1 + (k + 1);
+		unit_type* b2 = bm1 + (k + 1);
+		unit_type* v1 = b2 + (k + 1);
+		unit_type* vm1 = v1 + m;
+		unit_type* v2 = vm1 + m;
+		unit_type* next_scratch = v2 + m;
+		unit_type* v0 = r;
+		unit_type* vinf = r + 4 * k;
+
+		bool negative = false;
+		if (a == b) {
+			Multiplication::toom3_evaluate(a1, am1, a2, a, k, high);
+			b1 = a1;
+			bm1 = am1;
+			b2 = a2;
+		} else {
+			negative = Multiplication::toom3_evaluate(a1, am1, a2, a, k, high) !=
+					   Multiplication::toom3_evaluate(b1, bm1, b2, b, k, high);
+		}
+
+		if (pool != nullptr && n >= parallel_threshold) {
+			/* Each product gets its own share of the scratch */
+			uint64_t share = Multiplication::mul_n_scratch_size(k + 1, true);
+			pool->invoke([=] { Multiplication::mul_n(v1, a1, b1, k + 1, next_scratch, pool); },
+						 [=] { Multiplication::mul_n(vm1, am1, bm1, k + 1, next_scratch + share, pool); },
+						 [=] { Multiplication::mul_n(v2, a2, b2, k + 1, next_scratch + 2 * share, pool); },
+						 [=] { Multiplication::mul_n(v0, a, b, k, next_scratch + 3 * share, pool); },
+						 [=] { Multiplication::mul_n(vinf, a + 2 * k, b + 2 * k, high, next_scratch + 4 * share, pool); });
+		} else {
+			Multiplication::mul_n(v1, a1, b1, k + 1, next_scratch);
+			Multiplication::mul_n(vm1, am1, bm1, k + 1, next_scratch);
+			Multiplication::mul_n(v2, a2, b2, k + 1, next_scratch);
+			Multiplication::mul_n(v0, a, b, k, next_scratch);
+			Multiplication::mul_n(vinf, a + 2 * k, b + 2 * k, high, next_scratch);
+		}
+
+		/* Interpolation for the points 0, 1, -1, 2 and infinity */
+		if (negative) {
+			LimbKernels::add_n(v2, v2, vm1, m);
+			LimbKernels::add_n(vm1, v1, vm1, m);
+		} else {
+			LimbKernels::sub_n(v2, v2, vm1, m);
+			LimbKernels::sub_n(vm1, v1, vm1, m);
+		}
+		Multiplication::divexact_by3(v2, v2, m);
+		LimbKernels::rshift(vm1, vm1, m, 1);
+		LimbKernels::sub(v1, v1, m, v0, 2 * k);
+		LimbKernels::sub_n(v2, v2, v1, m);
+		LimbKernels::rshift(v2, v2, m, 1);
+		LimbKernels::sub_n(v1, v1, vm1, m);
+		LimbKernels::sub(v1, v1, m, vinf, 2 * high);
+		LimbKernels::sub(v2, v2, m, vinf, 2 * high);
+		LimbKernels::sub(v2, v2, m, vinf, 2 * high);
+		LimbKernels::sub_n(vm1, vm1, v2, m);
+
+		LimbKernels::zero(r + 2 * k, 2 * k);
+		Multiplication::add_into(r + k, 2 * n - k, vm1, m);
+		Multiplication::add_into(r + 2 * k, 2 * n - 2 * k, v1, m);
+		Multiplication::add_into(r + 3 * k, 2 * n - 3 * k, v2, m);
+	}
+
+	static constexpr uint64_t scratch_size(uint64_t an, uint64_t bn, bool parallel) {
+		if (bn < karatsuba_threshold) {
+			return 0;
+		}
+
+		if (an == bn) {
+			return Multiplication::mul_n_scratch_size(bn, parallel);
+		}
+
+		uint64_t rest = an % bn;
+		uint64_t size = Multiplication::mul_n_scratch_size(bn, parallel);
+		if (rest != 0) {
+			size = std::max(size, Multiplication::scratch_size(bn, rest, parallel));
+		}
+
+		return 2 * bn + size;
+	}
+
+	static constexpr void mul_unbalanced(unit_type* r, const unit_type* a, uint64_t an, const unit_type* b, uint64_t bn,
+										 unit_type* scratch, ThreadPool* pool) {
+		if (bn < karatsuba_threshold || LimbKernels::vector_basecase(an, bn)) {
+			LimbKernels::mul_basecase(r, a, an, b, bn);
+			return;
+		}
+
+		if (an == bn) {
+			Multiplication::mul_n(r, a, b, bn, scratch, pool);
+			return;
+		}
+
+		unit_type* product = scratch;
+		unit_type* next_scratch = scratch + 2 * bn;
+		uint64_t offset = bn;
+
+		Multiplication::mul_n(r, a, b, bn, next_scratch, pool);
+		for (; an - offset >= bn; offset += bn) {
+			Multiplication::mul_n(product, a + offset, b, bn, next_scratch, pool);
+			unit_type carry = LimbKernels::add_n(r + offset, r + offset, product, bn);
+			LimbKernels::add_1(r + offset + bn, product + bn, bn, carry);
+		}
+
+		uint64_t rest = an - offset;
+		if (rest != 0) {
+			Multiplication::mul_unbalanced(product, b, bn, a + offset, rest, next_scratch, pool);
+			unit_type carry = LimbKernels::add_n(r + offset, r + offset, product, bn);
+			LimbKernels::add_1(r + offset + bn, product + bn, rest, carry);
+		}
+	}
+
+public:
+
+	/* The parallel size leaves every product of a Toom-3 level that goes to the pool its own scratch */
+	static constexpr uint64_t mul_n_scratch_size(uint64_t n, bool parallel = false) {
+		if (n < karatsuba_threshold) {
+			return 0;
+		}
+
+		if (n < toom3_threshold) {
+			uint64_t low = n - n / 2;
+			return 4 * low + Multiplication::mul_n_scratch_size(low);
+		}
+
+		uint64_t k = (n + 2) / 3;
+		uint64_t products = parallel && n >= parallel_threshold ? 5 : 1;
+		return 6 * (k + 1) + 3 * (2 * k + 2) + products * Multiplication::mul_n_scratch_size(k + 1, parallel);
+	}
+
+	/*
+	 * Balanced product, r must hold 2 * n limbs and must not overlap the operands, a == b squares. Given a pool, products
+	 * from parallel_threshold limbs up spread over it and the scratch must hold mul_n_scratch_size(n, true) limbs.
+	 */
+	static constexpr void mul_n(unit_type* r, const unit_type* a, const unit_type* b, uint64_t n, unit_type* scratch,
+								ThreadPool* pool = nullptr) {
+		if (n < karatsuba_threshold) {
+			if (a == b) {
+				LimbKernels::sqr_basecase(r, a, n);
+			} else {
+				LimbKernels::mul_basecase(r, a, n, b, n);
+			}
+		} else if (LimbKernels::vector_basecase(n, n)) {
+			LimbKernels::mul_basecase(r, a, n, b, n);
+		} else if (n >= ntt_threshold && 2 * n <= NumberTheoreticTransform::max_product_size) {
+			if (pool != nullptr) {
+				NumberTheoreticTransform::mul_parallel(r, a, n, b, n, *pool);
+			} else {
+				NumberTheoreticTransform::mul(r, a, n, b, n);
+			}
+		} else if (n < toom3_threshold) {
+			Multiplication::karatsuba_n(r, a, b, n, scratch);
+		} else {
+			Multiplication::toom3_n(r, a, b, n, scratch, pool);
+		}
+	}
+
+	/* r must hold an + bn limbs and must not overlap the operands, requires an >= bn > 0, a == b squares */
+	static constexpr void mul(unit_type* r, const unit_type* a, uint64_t an, const unit_type* b, uint64_t bn) {
+		if (bn < karatsuba_threshold) {
+			if (a == b && an == bn) {
+				LimbKernels::sqr_basecase(r, a, an);
+			} else {
+				LimbKernels::mul_basecase(r, a, an, b, bn);
+			}
+			return;
+		}
+
+		if (bn >= ntt_threshold && an + bn <= NumberTheoreticTransform::max_product_size) {
+			NumberTheoreticTransform::mul(r, a, an, b, bn);
+			return;
+		}
+
+		limb_vector scratch(Multiplication::scratch_size(an, bn, false));
+		Multiplication::mul_unbalanced(r, a, an, b, bn, scratch.data(), nullptr);
+	}
+
+	/* mul with the Toom-3 products and the transforms spread over the pool, small products stay on the calling thread */
+	static void mul_parallel(unit_type* r, const unit_type* a, uint64_t an, const unit_type* b, uint64_t bn, ThreadPool& pool) {
+		if (bn < parallel_threshold || pool.concurrency() == 1) {
+			Multiplication::mul(r, a, an, b, bn);
+			return;
+		}
+
+		if (bn >= ntt_threshold && an + bn <= NumberTheoreticTransform::max_product_size) {
+			NumberTheoreticTransform::mul_parallel(r, a, an, b, bn, pool);
+			return;
+		}
+
+		limb_vector scratch(Multiplication::scratch_size(an, bn, true));
+		Multiplication::mul_unbalanced(r, a, an, b, bn, scratch.data(), &pool);
+	}
+
+	/*
+	 * Adds a * b into r (rn >= an + bn limbs) and returns the carry out of r, the operands may come in any order.
+	 * r must not overlap them, scratch holds an + bn limbs and is unused below the Karatsuba threshold.
+	 */
+	static constexpr unit_type addmul(unit_type* r, uint64_t rn, const unit_type* a, uint64_t an, const unit_type* b,
+									  uint64_t bn, unit_type* scratch) {
+		if (an < bn) {
+			return Multiplication::addmul(r, rn, b, bn, a, an, scratch);
+		}
+
+		if (bn < karatsuba_threshold) {
+			return LimbKernels::addmul_basecase(r, rn, a, an, b, bn);
+		}
+
+		Multiplication::mul(scratch, a, an, b, bn);
+		unit_type carry = LimbKernels::add_n(r, r, scratch, an + bn);
+		return LimbKernels::increment(r + an + bn, rn - an - bn, carry);
+	}
+
+	/* Subtracts a * b from r under the same conditions as addmul, returns the borrow out of r, a pool multiplies in parallel */
+	static constexpr unit_type submul(unit_type* r, uint64_t rn, const unit_type* a, uint64_t an, const unit_type* b,
+									  uint64_t bn, unit_type* scratch, ThreadPool* pool = nullptr) {
+		if (an < bn) {
+			return Multiplication::submul(r, rn, b, bn, a, an, scratch, pool);
+		}
+
+		if (bn < karatsuba_threshold) {
+			return LimbKernels::submul_basecase(r, rn, a, an, b, bn);
+		}
+
+		if consteval {
+			Multiplication::mul(scratch, a, an, b, bn);
+		} else {
+			if (pool != nullptr) {
+				Multiplication::mul_parallel(scratch, a, an, b, bn, *pool);
+			} else {
+				Multiplication::mul(scratch, a, an, b, bn);
+			}
+		}
+		unit_type borrow = LimbKernels::sub_n(r, r, scratch, an + bn);
+		return LimbKernels::decrement(r + an + bn, rn - an - bn, borrow);
+	}
+};
@@ -0,0 +1,379 @@
+#pragma once
+
+#include <array>
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+
+#include <Instrumentation.hpp>
+#include <LimbKernels.hpp>
+#include <LimbAllocator.hpp>
+#include <ThreadPool.hpp>
+
+/* Prime below 2^62 with Montgomery arithmetic over R = 2^64, values are kept in [0, value) */
+class NttPrime {
+public:
+	using unit_type = LimbKernels::unit_type;
+	using next_type = LimbKernels::next_type;
+
+	unit_type value;
+	unit_type generator;
+	unit_type inverse = 1;
+	unit_type r2;
+
+	constexpr NttPrime(unit_type modulus, unit_type primitive_root) : value(modulus), generator(primitive_root) {
+		for (int32_t i = 0; i < 6; i++) {
+			inverse *= 2 - modulus * inverse;
+		}
+		inverse = 0 - inverse;
+
+		unit_type r = static_cast<unit_type>((static_cast<next_type>(1) << LimbKernels::unit_bits) % modulus);
+		r2 = static_cast<unit_type>(static_cast<next_type>(r) * r % modulus);
+	}
+
+	[[nodiscard]] constexpr unit_type mul(unit_type a, unit_type b) const {
+		unit_type result = this->mul_lazy(a, b);
+		return std::min(result, result - value);
+	}
+
+	/* Requires a * b < 2^64 * value, the result is below 2 * value */
+	[[nodiscard]] constexpr unit_type mul_lazy(unit_type a, unit_type b) const {
+		next_type product = static_cast<next_type>(a) * b;
+		unit_type m = static_cast<unit_type>(product) * inverse;
+		return static_cast<unit_type>((product + static_cast<next_type>(m) * value) >> LimbKernels::unit_bits);
+	}
+
+	[[nodiscard]] constexpr unit_type add(unit_type a, unit_type b) const {
+		unit_type sum = a + b;
+		return std::min(sum, sum - value);
+	}
+
+	[[nodiscard]] constexpr unit_type sub(unit_type a, unit_type b) const {
+		unit_type difference = a - b;
+		return std::min(difference, difference + value);
+	}
+
+	[[nodiscard]] constexpr unit_type reduce(unit_type a) const {
+		while (a >= value) {
+			a -= value;
+		}
+		return a;
+	}
+
+	[[nodiscard]] constexpr unit_type to_montgomery(unit_type a) const {
+		return this->mul(this->reduce(a), r2);
+	}
+
+	/* Base and result in Montgomery form */
+	[[nodiscard]] constexpr unit_type power(unit_type base, uint64_t exponent) const {
+		unit_type result = this->to_montgomery(1);
+		while (exponent != 0) {
+			if (exponent & 1U) {
+				result = this->mul(result, base);
+			}
+			base = this->mul(base, base);
+			exponent >>= 1;
+		}
+		return result;
+	}
+};
+
+class NumberTheoreticTransform {
+public:
+	using unit_type = LimbKernels::unit_type;
+	using next_type = LimbKernels::next_type;
+
+private:
+
+	static constexpr std::array<NttPrime, 3> moduli = {
+		NttPrime(0x3FFFC00000000001ULL, 11),
+		NttPrime(0x3FFF840000000001ULL, 19),
+		NttPrime(0x3FFF540000000001ULL, 5)
+	};
+
+	static constexpr uint64_t max_length_bits = 42;
+
+	/* Constants for Garner's reconstruction, in Montgomery form */
+	static constexpr unit_type inverse_p1_mod_p2 = moduli[1].power(moduli[1].to_montgomery(moduli[0].value),
+																	moduli[1].value - 2);
+	static constexpr unit_type p1_mod_p3 = moduli[2].to_montgomery(moduli[0].value);
+	static constexpr unit_type inverse_p1p2_mod_p3 = moduli[2].power(moduli[2].mul(moduli[2].to_montgomery(moduli[0].value),
+																				   moduli[2].to_montgomery(moduli[1].value)),
+																	 moduli[2].value - 2);
+	static constexpr next_type p1p2 = static_cast<next_type>(moduli[0].value) * moduli[1].value;
+
+	/* Parallel loops hand out this many elements per task */
+	static constexpr uint64_t parallel_grain = static_cast<uint64_t>(1) << 14;
+
+	/* Transform stages within blocks of this many elements run block by block on one thread */
+	static constexpr uint64_t parallel_block = static_cast<uint64_t>(1) << 12;
+
+	/* Calls function(begin, end) once over the whole range, or on pieces spread over the pool */
+	template<typename Function>
+	static constexpr void range(ThreadPool* pool, uint64_t begin, uint64_t end, const Function& function) {
+		if (pool == nullptr) {
+			function(begin, end);
+		} else {
+			pool->for_each(begin, end, parallel_grain, function);
+		}
+	}
+
+	/* roots[h + j] holds w^j for the primitive 2h-th root of unity w derived from root, in Montgomery form */
+	static constexpr limb_vector roots(const NttPrime& modulus, uint64_t length, unit_type root, ThreadPool* pool) {
+		limb_vector table(length);
+		uint64_t half = length / 2;
+
+		NumberTheoreticTransform::range(pool, 0, half, [&](uint64_t begin, uint64_t end) {
+			unit_type power = modulus.power(root, begin);
+			for (uint64_t j = begin; j < end; j++) {
+				table[half + j] = power;
+				power = modulus.mul(power, root);
+			}
+		});
+		for (uint64_t h = half / 2; h >= 1; h /= 2) {
+			for (uint64_t j = 0; j < h; j++) {
+				table[h + j] = table[2 * h + 2 * j];
+			}
+		}
+		return table;
+	}
+
+	/* Butterflies begin to end, counted across the blocks, of the forward stage with distance h */
+	static constexpr void forward_stage(unit_type* a, uint64_t h, uint64_t begin, uint64_t end, const NttPrime& prime,
+										const unit_type* table) {
+		const NttPrime modulus = prime;
+		const unit_type twice = 2 * modulus.value;
+		uint64_t start = begin / h * 2 * h;
+		uint64_t j = begin % h;
+		while (begin < end) {
+			uint64_t stop = std::min(h, j + (end - begin));
+			begin += stop - j;
+			for (; j < stop; j++) {
+				unit_type u = a[start + j];
+				unit_type v = a[start + j + h];
+				unit_type sum = u + v;
+				a[start + j] = std::min(sum, sum - twice);
+				a[start + j + h] = modulus.mul_lazy(u - v + twice, table[h + j]);
+			}
+			j = 0;
+			start += 2 * h;
+		}
+	}
+
+	/* Butterflies begin to end, counted across the blocks, of the inverse stage with distance h */
+	static constexpr void inverse_stage(unit_type* a, uint64_t h, uint64_t begin, uint64_t end, const NttPrime& prime,
+										const unit_type* inverse_table) {
+		const NttPrime modulus = prime;
+		const unit_type twice = 2 * modulus.value;
+		uint64_t start = begin / h * 2 * h;
+		uint64_t j = begin % h;
+		while (begin < end) {
+			uint64_t stop = std::min(h, j + (end - begin));
+			begin += stop - j;
+			for (; j < stop; j++) {
+				unit_type u = a[start + j];
+				unit_type v = modulus.mul_lazy(a[start + j + h], inverse_table[h + j]);
+				unit_type sum = u + v;
+				unit_type difference = u - v + twice;
+				a[start + j] = std::min(sum, sum - twice);
+				a[start + j + h] = std::min(difference, difference - twice);
+			}
+			j = 0;
+			start += 2 * h;
+		}
+	}
+
+	/*
+	 * Decimation in frequency, leaves the result in bit reversed order, values are kept lazily in [0, 2 * value). In
+	 * parallel the stages spanning more than a block split their butterflies between tasks, the rest runs on whole blocks.
+	 */
+	static constexpr void forward(unit_type* a, uint64_t length, const NttPrime& prime, const unit_type* table,
+								  ThreadPool* pool) {
+		if (pool != nullptr && length > parallel_block) {
+			for (uint64_t h = length / 2; h >= parallel_block; h /= 2) {
+				pool->for_each(0, length / 2, parallel_grain, [=](uint64_t begin, uint64_t end) {
+					NumberTheoreticTransform::forward_stage(a, h, begin, end, prime, table);
+				});
+			}
+			pool->for_each(0, length / parallel_block, parallel_grain / parallel_block, [=](uint64_t begin, uint64_t end) {
+				for (uint64_t block = begin; block < end; block++) {
+					NumberTheoreticTransform::forward(a + block * parallel_block, parallel_block, prime, table, nullptr);
+				}
+			});
+			return;
+		}
+
+		const NttPrime modulus = prime;
+		const unit_type twice = 2 * modulus.value;
+		for (uint64_t h = length / 2; h >= 1; h /= 2) {
+			for (uint64_t start = 0; start < length; start += 2 * h) {
+				for (uint64_t j = 0; j < h; j++) {
+					unit_type u = a[start + j];
+					unit_type v = a[start + j + h];
+					unit_type sum = u + v;
+					a[start + j] = std::min(sum, sum - twice);
+					a[start + j + h] = modulus.mul_lazy(u - v + twice, table[h + j]);
+				}
+			}
+		}
+	}
+
+	/* Decimation in time on bit reversed input, inverse_table[h + j] holds w^-j, split between tasks like forward */
+	static constexpr void inverse(unit_type* a, uint64_t length, const NttPrime& prime, const unit_type* inverse_table,
+								  ThreadPool* pool) {
+		if (pool != nullptr && length > parallel_block) {
+			pool->for_each(0, length / parallel_block, parallel_grain / parallel_block, [=](uint64_t begin, uint64_t end) {
+				for (uint64_t block = begin; block < end; block++) {
+					NumberTheoreticTransform::inverse(a + block * parallel_block, parallel_block, prime, inverse_table, nullptr);
+				}
+			});
+			for (uint64_t h = parallel_block; h < length; h *= 2) {
+				pool->for_each(0, length / 2, parallel_grain, [=](uint64_t begin, uint64_t end) {
+					NumberTheoreticTransform::inverse_stage(a, h, begin, end, prime, inverse_table);
+				});
+			}
+			return;
+		}
+
+		const NttPrime modulus = prime;
+		const unit_type twice = 2 * modulus.value;
+		for (uint64_t h = 1; h < length; h *= 2) {
+			for (uint64_t start = 0; start < length; start += 2 * h) {
+				for (uint64_t j = 0; j < h; j++) {
+					unit_type u = a[start + j];
+					unit_type v = modulus.mul_lazy(a[start + j + h], inverse_table[h + j]);
+					unit_type sum = u + v;
+					unit_type difference = u - v + twice;
+					a[start + j] = std::min(sum, sum - twice);
+					a[start + j + h] = std::min(difference, difference - twice);
+				}
+			}
+		}
+	}
+
+	/* Cyclic convolution modulo one prime into the length zeroed limbs of x, both transforms run side by side */
+	static constexpr void convolve(limb_vector& x, const unit_type* a, uint64_t an, const unit_type* b,
+								   uint64_t bn, uint64_t length, const NttPrime& modulus, ThreadPool* pool) {
+		unit_type root = modulus.power(modulus.to_montgomery(modulus.generator), (modulus.value - 1) / length);
+		limb_vector table = NumberTheoreticTransform::roots(modulus, length, root, pool);
+		unit_type scale = modulus.to_montgomery(modulus.to_montgomery(modulus.value - (modulus.value - 1) / length));
+
+		auto transform = [&](unit_type* y, const unit_type* c, uint64_t cn) {
+			NumberTheoreticTransform::range(pool, 0, cn, [=](uint64_t begin, uint64_t end) {
+				for (uint64_t i = begin; i < end; i++) {
+					y[i] = modulus.reduce(c[i]);
+				}
+			});
+			NumberTheoreticTransform::forward(y, length, modulus, table.data(), pool);
+		};
+
+		if (a == b && an == bn) {
+			transform(x.data(), a, an);
+			NumberTheoreticTransform::range(pool, 0, length, [&](uint64_t begin, uint64_t end) {
+				for (uint64_t i = begin; i < end; i++) {
+					x[i] = modulus.mul(modulus.mul(x[i], x[i]), scale);
+				}
+			});
+		} else {
+			limb_vector y(length, 0);
+			if (pool == nullptr) {
+				transform(x.data(), a, an);
+				transform(y.data(), b, bn);
+			} else {
+				pool->invoke([&] { transform(x.data(), a, an); }, [&] { transform(y.data(), b, bn); });
+			}
+
+			NumberTheoreticTransform::range(pool, 0, length, [&](uint64_t begin, uint64_t end) {
+				for (uint64_t i = begin; i < end; i++) {
+					x[i] = modulus.mul(modulus.mul(x[i], y[i]), scale);
+				}
+			});
+		}
+
+		table = NumberTheoreticTransform::roots(modulus, length, modulus.power(root, length - 1), pool);
+		NumberTheoreticTransform::inverse(x.data(), length, modulus, table.data(), pool);
+	}
+
+	/* Replaces the residues at positions begin to end by the three limbs of the coefficient they determine */
+	static constexpr void reconstruct(std::array<limb_vector, 3>& residues, uint64_t begin, uint64_t end) {
+		const NttPrime& m2 = moduli[1];
+		const NttPrime& m3 = moduli[2];
+		for (uint64_t i = begin; i < end; i++) {
+			unit_type r1 = moduli[0].reduce(residues[0][i]);
+			unit_type r2 = m2.reduce(residues[1][i]);
+			unit_type r3 = m3.reduce(residues[2][i]);
+
+			unit_type t2 = m2.mul(m2.sub(r2, m2.reduce(r1)), inverse_p1_mod_p2);
+			next_type x12 = r1 + static_cast<next_type>(moduli[0].value) * t2;
+			unit_type x12_mod_p3 = m3.add(m3.reduce(r1), m3.mul(t2, p1_mod_p3));
+			unit_type t3 = m3.mul(m3.sub(r3, x12_mod_p3), inverse_p1p2_mod_p3);
+
+			next_type low = static_cast<next_type>(t3) * static_cast<unit_type>(p1p2);
+			next_type high = static_cast<next_type>(t3) * static_cast<unit_type>(p1p2 >> LimbKernels::unit_bits);
+			next_type sum = (x12 & ~static_cast<unit_type>(0)) + (low & ~static_cast<unit_type>(0));
+			residues[0][i] = static_cast<unit_type>(sum);
+			sum = (sum >> LimbKernels::unit_bits) + (x12 >> LimbKernels::unit_bits) + (low >> LimbKernels::unit_bits) +
+				  (high & ~static_cast<unit_type>(0));
+			residues[1][i] = static_cast<unit_type>(sum);
+			residues[2][i] = static_cast<unit_type>((sum >> LimbKernels::unit_bits) + (high >> LimbKernels::unit_bits));
+		}
+	}
+
+	static constexpr void multiply(unit_type* r, const unit_type* a, uint64_t an, const unit_type* b, uint64_t bn,
+								   ThreadPool* pool) {
+		BIGNUMBER_INSTRUMENT(ntt, an);
+		uint64_t length = std::bit_ceil(an + bn - 1);
+		std::array<limb_vector, 3> residues = {limb_vector(length, 0), limb_vector(length, 0), limb_vector(length, 0)};
+
+		if (pool == nullptr) {
+			for (uint64_t i = 0; i < moduli.size(); i++) {
+				NumberTheoreticTransform::convolve(residues[i], a, an, b, bn, length, moduli[i], nullptr);
+			}
+		} else {
+			pool->invoke([&] { NumberTheoreticTransform::convolve(residues[0], a, an, b, bn, length, moduli[0], pool); },
+						 [&] { NumberTheoreticTransform::convolve(residues[1], a, an, b, bn, length, moduli[1], pool); },
+						 [&] { NumberTheoreticTransform::convolve(residues[2], a, an, b, bn, length, moduli[2], pool); });
+		}
+
+		if (pool != nullptr) {
+			pool->for_each(0, an + bn - 1, parallel_grain, [&](uint64_t begin, uint64_t end) {
+				NumberTheoreticTransform::reconstruct(residues, begin, end);
+			});
+		}
+
+		/* The carries run in order, on one thread the coefficients are reconstructed just ahead of them */
+		unit_type carry0 = 0, carry1 = 0;
+		for (uint64_t i = 0; i < an + bn; i++) {
+			if (pool == nullptr && i % parallel_block == 0) {
+				NumberTheoreticTransform::reconstruct(residues, i, std::min(i + parallel_block, an + bn - 1));
+			}
+
+			unit_type x0 = 0, x1 = 0, x2 = 0;
+			if (i < an + bn - 1) {
+				x0 = residues[0][i];
+				x1 = residues[1][i];
+				x2 = residues[2][i];
+			}
+
+			next_type sum = static_cast<next_type>(carry0) + x0;
+			r[i] = static_cast<unit_type>(sum);
+			sum = (sum >> LimbKernels::unit_bits) + carry1 + x1;
+			carry0 = static_cast<unit_type>(sum);
+			carry1 = static_cast<unit_type>(sum >> LimbKernels::unit_bits) + x2;
+		}
+	}
+
+public:
+
+	static constexpr uint64_t max_product_size = (static_cast<uint64_t>(1) << max_length_bits) + 1;
+
+	/* r must hold an + bn limbs and must not overlap the operands, a == b squares with one transform per prime */
+	static constexpr void mul(unit_type* r, const unit_type* a, uint64_t an, const unit_type* b, uint64_t bn) {
+		NumberTheoreticTransform::multiply(r, a, an, b, bn, nullptr);
+	}
+
+	/* mul with the three primes, the transforms and the pointwise products spread over the pool */
+	static void mul_parallel(unit_type* r, const unit_type* a, uint64_t an, const unit_type* b, uint64_t bn, ThreadPool& pool) {
+		NumberTheoreticTransform::multiply(r, a, an, b, bn, &pool);
+	}
+};
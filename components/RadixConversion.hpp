@@ -0,0 +1,352 @@
+#pragma once
+
+#include <bit>
+#include <array>
+#include <deque>
+#include <mutex>
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+
+#include <Instrumentation.hpp>
+#include <LimbKernels.hpp>
+#include <LimbAllocator.hpp>
+#include <Multiplication.hpp>
+#include <Division.hpp>
+
+class RadixConversion {
+public:
+	using unit_type = LimbKernels::unit_type;
+
+	static constexpr uint64_t digits_per_unit = 19;
+	static constexpr unit_type decimal_unit = 10000000000000000000ULL;
+
+	static constexpr uint64_t parse_threshold = 40;
+	static constexpr uint64_t print_threshold = 30;
+
+private:
+
+	/*
+	 * 10^(19 * 2^level) of k limbs and, once printing needs them, its normalized form and approximate reciprocal.
+	 * Powers live as long as the process and are allocated outside of the current resource.
+	 */
+	struct Power {
+		std::vector<unit_type> limbs;
+		std::vector<unit_type> normalized;
+		std::vector<unit_type> reciprocal;
+		uint64_t shift = 0;
+		uint64_t digits = 0;
+	};
+
+	/* Powers are computed once by repeated squaring and shared between threads, references stay valid */
+	static const Power& power(uint64_t level, bool with_reciprocal = false) {
+		static std::mutex mutex;
+		static std::deque<Power> powers;
+		std::lock_guard<std::mutex> lock(mutex);
+
+		while (powers.size() <= level) {
+			Power next;
+			if (powers.empty()) {
+				next.limbs.push_back(decimal_unit);
+				next.digits = digits_per_unit;
+			} else {
+				const Power& previous = powers.back();
+				uint64_t n = previous.limbs.size();
+				next.limbs.resize(2 * n);
+				Multiplication::mul(next.limbs.data(), previous.limbs.data(), n, previous.limbs.data(), n);
+				next.limbs.resize(LimbKernels::normalized_size(next.limbs.data(), 2 * n));
+				next.digits = 2 * previous.digits;
+			}
+			powers.push_back(std::move(next));
+		}
+
+		Power& p = powers[level];
+		if (with_reciprocal && p.reciprocal.empty()) {
+			uint64_t k = p.limbs.size();
+			p.shift = static_cast<uint64_t>(std::countl_zero(p.limbs.back()));
+			p.normalized = p.limbs;
+			if (p.shift != 0) {
+				LimbKernels::lshift(p.normalized.data(), p.limbs.data(), k, p.shift);
+			}
+			p.reciprocal.resize(k + 1);
+			Division::invert(p.reciprocal.data(), p.normalized.data(), k);
+		}
+
+		return p;
+	}
+
+	/* Product of two blocks, the kernel expects the longer operand first */
+	static void mul(unit_type* r, const unit_type* a, uint64_t an, const unit_type* b, uint64_t bn) {
+		if (an >= bn) {
+			Multiplication::mul(r, a, an, b, bn);
+		} else {
+			Multiplication::mul(r, b, bn, a, an);
+		}
+	}
+
+	/*
+	 * Barrett division of a (n <= 2k limbs, shifted by the normalization below B^2k) by a cached power of k limbs.
+	 * The quotient estimated from the reciprocal is within a few units of the true one and is corrected in both directions.
+	 */
+	static void divide(limb_vector& q, limb_vector& r, const unit_type* a, uint64_t n, const Power& p) {
+		uint64_t k = p.normalized.size();
+		const unit_type* d = p.normalized.data();
+
+		r.assign(n + 2, 0);
+		if (p.shift != 0) {
+			r[n] = LimbKernels::lshift(r.data(), a, n, p.shift);
+		} else {
+			LimbKernels::copy(r.data(), a, n);
+		}
+
+		uint64_t top = n + 1 - (k - 1);
+		limb_vector estimate(top + k + 1);
+		RadixConversion::mul(estimate.data(), r.data() + k - 1, top, p.reciprocal.data(), k + 1);
+		q.assign(estimate.begin() + static_cast<int64_t>(k + 1), estimate.end());
+
+		uint64_t qn = LimbKernels::normalized_size(q.data(), top);
+		unit_type borrow = 0;
+		if (qn != 0) {
+			limb_vector scratch(qn + k);
+			borrow = Multiplication::submul(r.data(), n + 2, q.data(), qn, d, k, scratch.data());
+		}
+
+		while (borrow != 0) {
+			borrow -= LimbKernels::add(r.data(), r.data(), n + 2, d, k);
+			LimbKernels::sub_1(q.data(), q.data(), top, 1);
+		}
+		while (LimbKernels::compare(r.data(), LimbKernels::normalized_size(r.data(), n + 2), d, k) >= 0) {
+			LimbKernels::sub(r.data(), r.data(), n + 2, d, k);
+			LimbKernels::add_1(q.data(), q.data(), top, 1);
+		}
+
+		if (p.shift != 0) {
+			LimbKernels::rshift(r.data(), r.data(), k, p.shift);
+		}
+		r.resize(k);
+	}
+
+	/* Horner's scheme over 19 digit chunks */
+	static constexpr uint64_t parse_basecase(unit_type* r, const char* digits, uint64_t length) {
+		uint64_t size = 0;
+		uint64_t chunk = length % digits_per_unit == 0 ? digits_per_unit : length % digits_per_unit;
+
+		for (uint64_t index = 0; index < length; index += chunk, chunk = digits_per_unit) {
+			unit_type value = 0;
+			for (uint64_t i = index; i < index + chunk; i++) {
+				value = value * 10 + static_cast<unit_type>(digits[i] - '0');
+			}
+
+			unit_type carry = LimbKernels::mul_1(r, r, size, decimal_unit);
+			carry += LimbKernels::add_1(r, r, size, value);
+			if (carry != 0) {
+				r[size] = carry;
+				size += 1;
+			}
+		}
+
+		return size;
+	}
+
+	/* Splits the digits at the largest cached power below them: value = high * 10^digits + low */
+	static uint64_t parse(unit_type* r, const char* digits, uint64_t length) {
+		if (length <= parse_threshold * digits_per_unit) {
+			return RadixConversion::parse_basecase(r, digits, length);
+		}
+
+		uint64_t level = 0;
+		while (2 * RadixConversion::power(level).digits < length) {
+			level += 1;
+		}
+
+		uint64_t high_length = length - RadixConversion::level_digits(level);
+		limb_vector high(high_length / digits_per_unit + 1);
+		uint64_t hn = RadixConversion::parse(high.data(), digits, high_length);
+		uint64_t ln = RadixConversion::parse(r, digits + high_length, RadixConversion::level_digits(level));
+		return RadixConversion::combine(r, high.data(), hn, r, ln, level);
+	}
+
+	/* Writes exactly digits characters, zero padded */
+	static constexpr char* write_unit(char* out, unit_type value, uint64_t digits) {
+		for (; digits > digits_per_unit; digits--) {
+			*out++ = '0';
+		}
+		for (uint64_t i = digits; i > 0; i--) {
+			out[i - 1] = static_cast<char>('0' + value % 10);
+			value /= 10;
+		}
+		return out + digits;
+	}
+
+	static constexpr uint64_t digit_count(unit_type value) {
+		uint64_t digits = 1;
+		for (; value >= 10; value /= 10) {
+			digits += 1;
+		}
+		return digits;
+	}
+
+	/* Repeated division by 10^19, requires n < print_threshold */
+	static constexpr char* print_basecase(char* out, const unit_type* a, uint64_t n, uint64_t width) {
+		std::array<unit_type, print_threshold> limbs{};
+		std::array<unit_type, 2 * print_threshold> chunks{};
+		uint64_t count = 0;
+
+		LimbKernels::copy(limbs.data(), a, n);
+		while (n != 0) {
+			chunks[count] = LimbKernels::divrem_1(limbs.data(), limbs.data(), n, decimal_unit);
+			count += 1;
+			n = LimbKernels::normalized_size(limbs.data(), n);
+		}
+
+		if (count == 0) {
+			return RadixConversion::write_unit(out, 0, width);
+		}
+
+		uint64_t top_digits = width == 0 ? RadixConversion::digit_count(chunks[count - 1])
+										 : width - digits_per_unit * (count - 1);
+		out = RadixConversion::write_unit(out, chunks[count - 1], top_digits);
+		for (uint64_t i = count - 1; i > 0; i--) {
+			out = RadixConversion::write_unit(out, chunks[i - 1], digits_per_unit);
+		}
+		return out;
+	}
+
+	/* Divides a (n >= print_threshold limbs) by the cached power of ten that halves it, returns the digits of the power */
+	static uint64_t split(limb_vector& quotient, limb_vector& remainder, const unit_type* a, uint64_t n) {
+		uint64_t level = 0;
+		while (2 * RadixConversion::power(level).limbs.size() < n) {
+			level += 1;
+		}
+
+		/* A value of 2k limbs may still be too large for the power of k limbs once shifted */
+		const Power* p = &RadixConversion::power(level, true);
+		if (2 * p->limbs.size() == n && p->shift != 0 && (a[n - 1] >> (LimbKernels::unit_bits - p->shift)) != 0) {
+			p = &RadixConversion::power(level + 1, true);
+		}
+
+		RadixConversion::divide(quotient, remainder, a, n, *p);
+		return p->digits;
+	}
+
+	/* Writes the value zero padded to width digits, or without leading zeros when width is 0 */
+	static char* print(char* out, const unit_type* a, uint64_t n, uint64_t width) {
+		if (n < print_threshold) {
+			return RadixConversion::print_basecase(out, a, n, width);
+		}
+
+		limb_vector quotient, remainder;
+		uint64_t digits = RadixConversion::split(quotient, remainder, a, n);
+		uint64_t qn = LimbKernels::normalized_size(quotient.data(), quotient.size());
+		uint64_t rn = LimbKernels::normalized_size(remainder.data(), remainder.size());
+		if (width == 0 && qn == 0) {
+			return RadixConversion::print(out, remainder.data(), rn, 0);
+		}
+
+		out = RadixConversion::print(out, quotient.data(), qn, width == 0 ? 0 : width - digits);
+		return RadixConversion::print(out, remainder.data(), rn, digits);
+	}
+
+	/* print that hands the digits to the sink piece by piece through the buffer */
+	template<typename Sink>
+	static void print_chunked(char* buffer, uint64_t capacity, const unit_type* a, uint64_t n, uint64_t width, Sink& sink) {
+		if ((width == 0 ? RadixConversion::max_digits(n) : width) <= capacity) {
+			sink(buffer, static_cast<uint64_t>(RadixConversion::print(buffer, a, n, width) - buffer));
+			return;
+		}
+
+		if (n < print_threshold) {
+			/* Only zero padding makes a small value this wide */
+			uint64_t digits = n == 0 ? 0 : static_cast<uint64_t>(RadixConversion::print(buffer, a, n, 0) - buffer);
+			std::fill(buffer + digits, buffer + capacity, '0');
+			for (uint64_t zeros = width - digits; zeros != 0;) {
+				uint64_t count = std::min(zeros, capacity - digits);
+				sink(buffer + digits, count);
+				zeros -= count;
+			}
+			sink(buffer, digits);
+			return;
+		}
+
+		limb_vector quotient, remainder;
+		uint64_t digits = RadixConversion::split(quotient, remainder, a, n);
+		uint64_t qn = LimbKernels::normalized_size(quotient.data(), quotient.size());
+		uint64_t rn = LimbKernels::normalized_size(remainder.data(), remainder.size());
+		if (width == 0 && qn == 0) {
+			RadixConversion::print_chunked(buffer, capacity, remainder.data(), rn, 0, sink);
+			return;
+		}
+
+		RadixConversion::print_chunked(buffer, capacity, quotient.data(), qn, width == 0 ? 0 : width - digits, sink);
+		RadixConversion::print_chunked(buffer, capacity, remainder.data(), rn, digits, sink);
+	}
+
+public:
+
+	/* Digits of the power of ten a number is split at on the given level, 19 * 2^level */
+	static constexpr uint64_t level_digits(uint64_t level) {
+		return digits_per_unit << level;
+	}
+
+	/* Limbs of the power of ten of a level */
+	static uint64_t level_size(uint64_t level) {
+		return RadixConversion::power(level).limbs.size();
+	}
+
+	/*
+	 * r = high * 10^level_digits(level) + low for low below that power, r must hold hn + level_size(level) + 1 limbs and
+	 * may be low itself, returns the normalized size
+	 */
+	static uint64_t combine(unit_type* r, const unit_type* high, uint64_t hn, const unit_type* low, uint64_t ln,
+							uint64_t level) {
+		if (hn == 0) {
+			LimbKernels::copy(r, low, ln);
+			return ln;
+		}
+
+		const Power& p = RadixConversion::power(level);
+		uint64_t pn = p.limbs.size();
+		limb_vector product(hn + pn);
+		RadixConversion::mul(product.data(), high, hn, p.limbs.data(), pn);
+
+		uint64_t size = LimbKernels::normalized_size(product.data(), hn + pn);
+		LimbKernels::copy(r, low, ln);
+		LimbKernels::zero(r + ln, size - ln);
+		unit_type carry = LimbKernels::add(r, product.data(), size, r, ln);
+		if (carry != 0) {
+			r[size] = carry;
+			size += 1;
+		}
+		return size;
+	}
+
+	/* Upper bound on the decimal digits of a value with n limbs */
+	static constexpr uint64_t max_digits(uint64_t n) {
+		return n * digits_per_unit + n / 3 + 1;
+	}
+
+	/* Smallest buffer to_decimal_chunked works with, max_digits(print_threshold) */
+	static constexpr uint64_t min_chunk = print_threshold * digits_per_unit + print_threshold / 3 + 1;
+
+	/* Parses length decimal digits into r, which must hold length / 19 + 1 limbs, returns the normalized size */
+	static uint64_t from_decimal(unit_type* r, const char* digits, uint64_t length) {
+		BIGNUMBER_INSTRUMENT(parse, length / digits_per_unit + 1);
+		return LimbKernels::normalized_size(r, RadixConversion::parse(r, digits, length));
+	}
+
+	/* Writes the digits of a non zero value without leading zeros, out must hold max_digits(n) characters */
+	static char* to_decimal(char* out, const unit_type* a, uint64_t n) {
+		BIGNUMBER_INSTRUMENT(print, n);
+		return RadixConversion::print(out, a, n, 0);
+	}
+
+	/*
+	 * Same digits as to_decimal, handed in order to sink(const char*, uint64_t) in pieces of at most capacity characters
+	 * through a buffer of capacity >= min_chunk. Besides the buffer it needs about twice the memory of the value.
+	 */
+	template<typename Sink>
+	static void to_decimal_chunked(char* buffer, uint64_t capacity, const unit_type* a, uint64_t n, Sink&& sink) {
+		BIGNUMBER_INSTRUMENT(print, n);
+		RadixConversion::print_chunked(buffer, capacity, a, n, 0, sink);
+	}
+};
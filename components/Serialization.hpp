@@ -0,0 +1,194 @@
+#pragma once
+
+#include <bit>
+#include <span>
+#include <string>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+
+#include <LimbKernels.hpp>
+#include <NumberFormatException.hpp>
+
+/*
+ * Binary encoding of a signed integer, starting with a version byte and a flags byte in both forms.
+ *
+ * fixed:   version, flags, 6 zero bytes, limb count as 8 bytes little endian, limbs little endian
+ * compact: version, flags, magnitude as a LEB128 varint of 7 bits per byte, least significant group first
+ *
+ * The limbs of the fixed form start 16 bytes in, so they can be read in place from a buffer aligned to 8 bytes. The
+ * compact form suits small values. Both forms are canonical: no high zero limbs or groups and no negative zero.
+ */
+class Serialization {
+public:
+	using unit_type = LimbKernels::unit_type;
+
+	enum class Format : uint8_t {
+		fixed,
+		compact
+	};
+
+	static constexpr uint8_t version = 1;
+	static constexpr uint8_t negative_flag = 1;
+	static constexpr uint8_t compact_flag = 2;
+	static constexpr uint64_t header_size = 16;
+
+	/* What the leading bytes of an encoding say, size counts the bytes of the whole encoding */
+	struct Header {
+		bool negative = false;
+		Format format = Format::fixed;
+		uint64_t limbs = 0;
+		uint64_t size = 0;
+	};
+
+private:
+
+	static constexpr uint64_t unit_bytes = sizeof(unit_type);
+	static constexpr uint64_t group_bits = 7;
+	static constexpr uint8_t continuation = 0x80;
+
+	[[noreturn]] static void malformed(uint64_t size) {
+		throw NumberFormatException("of " + std::to_string(size) + " bytes");
+	}
+
+	static unit_type load(const std::byte* in) {
+		unit_type value;
+		std::memcpy(&value, in, unit_bytes);
+		if constexpr (std::endian::native == std::endian::big) {
+			value = std::byteswap(value);
+		}
+		return value;
+	}
+
+	static void store(std::byte* out, unit_type value) {
+		if constexpr (std::endian::native == std::endian::big) {
+			value = std::byteswap(value);
+		}
+		std::memcpy(out, &value, unit_bytes);
+	}
+
+	static uint64_t significant_bits(const unit_type* a, uint64_t n) {
+		return n == 0 ? 0 : n * LimbKernels::unit_bits - static_cast<uint64_t>(std::countl_zero(a[n - 1]));
+	}
+
+public:
+
+	[[nodiscard]] static uint64_t size(const unit_type* a, uint64_t n, Format format) {
+		if (format == Format::fixed) {
+			return header_size + n * unit_bytes;
+		}
+		return 2 + std::max<uint64_t>((Serialization::significant_bits(a, n) + group_bits - 1) / group_bits, 1);
+	}
+
+	/* Encodes the normalized magnitude a with its sign, out must hold size(a, n, format) bytes, returns the bytes written */
+	static uint64_t write(std::byte* out, const unit_type* a, uint64_t n, bool negative, Format format) {
+		out[0] = std::byte{version};
+		out[1] = std::byte{static_cast<uint8_t>((negative && n != 0 ? negative_flag : 0) |
+												(format == Format::compact ? compact_flag : 0))};
+
+		if (format == Format::fixed) {
+			std::memset(out + 2, 0, 6);
+			Serialization::store(out + 8, n);
+			if constexpr (std::endian::native == std::endian::little) {
+				std::memcpy(out + header_size, a, n * unit_bytes);
+			} else {
+				for (uint64_t i = 0; i < n; i++) {
+					Serialization::store(out + header_size + i * unit_bytes, a[i]);
+				}
+			}
+			return header_size + n * unit_bytes;
+		}
+
+		uint64_t groups = Serialization::size(a, n, format) - 2;
+		for (uint64_t g = 0; g < groups; g++) {
+			uint64_t bit = g * group_bits;
+			uint64_t index = bit / LimbKernels::unit_bits;
+			uint64_t offset = bit % LimbKernels::unit_bits;
+			unit_type value = index < n ? a[index] >> offset : 0;
+			if (offset > LimbKernels::unit_bits - group_bits && index + 1 < n) {
+				value |= a[index + 1] << (LimbKernels::unit_bits - offset);
+			}
+			uint8_t group = static_cast<uint8_t>(value & 0x7F);
+			out[2 + g] = std::byte{static_cast<uint8_t>(group | (g + 1 < groups ? continuation : 0))};
+		}
+		return 2 + groups;
+	}
+
+	/* Validates the encoding at the front of bytes, which may go on past it */
+	[[nodiscard]] static Header read_header(std::span<const std::byte> bytes) {
+		if (bytes.size() < 3 || std::to_integer<uint8_t>(bytes[0]) != version ||
+			(std::to_integer<uint8_t>(bytes[1]) & ~(negative_flag | compact_flag)) != 0) {
+			Serialization::malformed(bytes.size());
+		}
+
+		Header header;
+		uint8_t flags = std::to_integer<uint8_t>(bytes[1]);
+		header.negative = (flags & negative_flag) != 0;
+		header.format = (flags & compact_flag) != 0 ? Format::compact : Format::fixed;
+
+		if (header.format == Format::fixed) {
+			if (bytes.size() < header_size) {
+				Serialization::malformed(bytes.size());
+			}
+			for (uint64_t i = 2; i < 8; i++) {
+				if (bytes[i] != std::byte{0}) {
+					Serialization::malformed(bytes.size());
+				}
+			}
+			header.limbs = Serialization::load(bytes.data() + 8);
+			if (header.limbs > (bytes.size() - header_size) / unit_bytes) {
+				Serialization::malformed(bytes.size());
+			}
+			header.size = header_size + header.limbs * unit_bytes;
+			if (header.limbs == 0 ? header.negative : Serialization::load(bytes.data() + header.size - unit_bytes) == 0) {
+				Serialization::malformed(bytes.size());
+			}
+			return header;
+		}
+
+		uint64_t groups = 0;
+		while (true) {
+			if (2 + groups == bytes.size()) {
+				Serialization::malformed(bytes.size());
+			}
+			if ((std::to_integer<uint8_t>(bytes[2 + groups++]) & continuation) == 0) {
+				break;
+			}
+		}
+		bool zero = groups == 1 && bytes[2] == std::byte{0};
+		if ((groups > 1 && bytes[1 + groups] == std::byte{0}) || (zero && header.negative)) {
+			Serialization::malformed(bytes.size());
+		}
+		header.limbs = zero ? 0 : (groups * group_bits + LimbKernels::unit_bits - 1) / LimbKernels::unit_bits;
+		header.size = 2 + groups;
+		return header;
+	}
+
+	/* Decodes the magnitude of a validated encoding into r, which must hold header.limbs limbs, returns its size */
+	static uint64_t read_limbs(unit_type* r, std::span<const std::byte> bytes, const Header& header) {
+		if (header.format == Format::fixed) {
+			if constexpr (std::endian::native == std::endian::little) {
+				std::memcpy(r, bytes.data() + header_size, header.limbs * unit_bytes);
+			} else {
+				for (uint64_t i = 0; i < header.limbs; i++) {
+					r[i] = Serialization::load(bytes.data() + header_size + i * unit_bytes);
+				}
+			}
+			return header.limbs;
+		}
+
+		LimbKernels::zero(r, header.limbs);
+		for (uint64_t g = 0; g + 2 < header.size; g++) {
+			unit_type group = std::to_integer<uint8_t>(bytes[2 + g]) & 0x7F;
+			uint64_t bit = g * group_bits;
+			uint64_t index = bit / LimbKernels::unit_bits;
+			uint64_t offset = bit % LimbKernels::unit_bits;
+			r[index] |= group << offset;
+			if (offset > LimbKernels::unit_bits - group_bits) {
+				r[index + 1] |= group >> (LimbKernels::unit_bits - offset);
+			}
+		}
+		return LimbKernels::normalized_size(r, header.limbs);
+	}
+};
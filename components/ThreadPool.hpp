@@ -0,0 +1,268 @@
+#pragma once
+
+#include <array>
+#include <deque>
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <cstdint>
+#include <utility>
+#include <algorithm>
+#include <exception>
+#include <execution>
+#include <condition_variable>
+
+/*
+ * Fork join pool with one task deque per worker. A worker pops the newest task of its own deque and steals the oldest
+ * task of the others. A thread waiting for the tasks it forked runs queued tasks meanwhile, so nested parallel calls
+ * never block a worker. A pool of concurrency n starts n - 1 workers, the thread calling into it is the n-th.
+ */
+class ThreadPool {
+private:
+
+	/* Lives on the stack of the forking thread until it is done */
+	struct Task {
+		void (*run)(void*) = nullptr;
+		void* function = nullptr;
+		std::atomic<bool> done = false;
+		std::exception_ptr error;
+	};
+
+	struct Queue {
+		std::mutex mutex;
+		std::deque<Task*> tasks;
+	};
+
+	static inline thread_local const ThreadPool* current_pool = nullptr;
+	static inline thread_local uint64_t current_index = 0;
+
+	/* One queue per worker, the last one is shared by the threads outside the pool */
+	std::vector<std::unique_ptr<Queue>> queues_;
+	std::atomic<uint64_t> queued_ = 0;
+	std::mutex sleep_mutex_;
+	std::condition_variable wake_;
+	bool stopping_ = false;
+	std::vector<std::jthread> workers_;
+
+	template<typename Function>
+	static void call(void* function) {
+		(*static_cast<Function*>(function))();
+	}
+
+	static std::unique_ptr<ThreadPool>& global_pool() {
+		static std::unique_ptr<ThreadPool> pool = std::make_unique<ThreadPool>(ThreadPool::default_concurrency());
+		return pool;
+	}
+
+	[[nodiscard]] uint64_t own_queue() const {
+		return current_pool == this ? current_index : queues_.size() - 1;
+	}
+
+	void push(Task* task, uint64_t index) {
+		{
+			std::lock_guard lock(queues_[index]->mutex);
+			queues_[index]->tasks.push_back(task);
+		}
+		{
+			std::lock_guard lock(sleep_mutex_);
+			queued_.fetch_add(1, std::memory_order_relaxed);
+		}
+		wake_.notify_one();
+	}
+
+	/* Removes the task from the queue unless another thread took it first */
+	bool take(Task* task, uint64_t index) {
+		std::lock_guard lock(queues_[index]->mutex);
+		auto& tasks = queues_[index]->tasks;
+		auto it = std::find(tasks.rbegin(), tasks.rend(), task);
+		if (it == tasks.rend()) {
+			return false;
+		}
+
+		tasks.erase(std::next(it).base());
+		queued_.fetch_sub(1, std::memory_order_relaxed);
+		return true;
+	}
+
+	/* Newest task of the own queue, otherwise the oldest task of the first other queue that has one */
+	Task* find(uint64_t index) {
+		for (uint64_t i = 0; i < queues_.size(); i++) {
+			Queue& queue = *queues_[(index + i) % queues_.size()];
+			std::lock_guard lock(queue.mutex);
+			if (queue.tasks.empty()) {
+				continue;
+			}
+
+			Task* task = nullptr;
+			if (i == 0) {
+				task = queue.tasks.back();
+				queue.tasks.pop_back();
+			} else {
+				task = queue.tasks.front();
+				queue.tasks.pop_front();
+			}
+			queued_.fetch_sub(1, std::memory_order_relaxed);
+			return task;
+		}
+		return nullptr;
+	}
+
+	static void execute(Task* task) {
+		try {
+			task->run(task->function);
+		} catch (...) {
+			task->error = std::current_exception();
+		}
+		task->done.store(true, std::memory_order_release);
+	}
+
+	/* Runs the task if it is still queued, otherwise helps with other tasks until whoever took it is done */
+	void join(Task* task, uint64_t index) {
+		if (this->take(task, index)) {
+			ThreadPool::execute(task);
+			return;
+		}
+
+		while (!task->done.load(std::memory_order_acquire)) {
+			if (Task* other = this->find(index)) {
+				ThreadPool::execute(other);
+			} else {
+				std::this_thread::yield();
+			}
+		}
+	}
+
+	void work(uint64_t index) {
+		current_pool = this;
+		current_index = index;
+		while (true) {
+			if (Task* task = this->find(index)) {
+				ThreadPool::execute(task);
+				continue;
+			}
+
+			std::unique_lock lock(sleep_mutex_);
+			wake_.wait(lock, [this] { return stopping_ || queued_.load(std::memory_order_relaxed) != 0; });
+			if (stopping_) {
+				return;
+			}
+		}
+	}
+
+public:
+
+	explicit ThreadPool(uint64_t concurrency) {
+		uint64_t workers = std::max<uint64_t>(concurrency, 1) - 1;
+		for (uint64_t i = 0; i <= workers; i++) {
+			queues_.push_back(std::make_unique<Queue>());
+		}
+		for (uint64_t i = 0; i < workers; i++) {
+			workers_.emplace_back([this, i] { this->work(i); });
+		}
+	}
+
+	ThreadPool(const ThreadPool&) = delete;
+	ThreadPool& operator=(const ThreadPool&) = delete;
+
+	/* Must not run while tasks are still queued */
+	~ThreadPool() {
+		{
+			std::lock_guard lock(sleep_mutex_);
+			stopping_ = true;
+		}
+		wake_.notify_all();
+		workers_.clear();
+	}
+
+	[[nodiscard]] static uint64_t default_concurrency() {
+		return std::max<uint64_t>(std::thread::hardware_concurrency(), 1);
+	}
+
+	/* Pool used by the parallel execution policies, created with the default concurrency on first use */
+	[[nodiscard]] static ThreadPool& global() {
+		return *ThreadPool::global_pool();
+	}
+
+	/* Replaces the global pool, must not run while the global pool is in use */
+	static void configure(uint64_t concurrency) {
+		ThreadPool::global_pool() = std::make_unique<ThreadPool>(concurrency);
+	}
+
+	/* Pool an execution policy runs on, none for the sequenced ones */
+	[[nodiscard]] static ThreadPool* executor(const std::execution::sequenced_policy&) {
+		return nullptr;
+	}
+
+	[[nodiscard]] static ThreadPool* executor(const std::execution::unsequenced_policy&) {
+		return nullptr;
+	}
+
+	[[nodiscard]] static ThreadPool* executor(const std::execution::parallel_policy&) {
+		return &ThreadPool::global();
+	}
+
+	[[nodiscard]] static ThreadPool* executor(const std::execution::parallel_unsequenced_policy&) {
+		return &ThreadPool::global();
+	}
+
+	[[nodiscard]] static ThreadPool* executor(ThreadPool& pool) {
+		return &pool;
+	}
+
+	[[nodiscard]] uint64_t concurrency() const {
+		return workers_.size() + 1;
+	}
+
+	/* Runs the functions, possibly in parallel, and returns when all of them are done, rethrowing the first exception */
+	template<typename First, typename... Rest>
+	void invoke(First&& first, Rest&&... rest) {
+		if (workers_.empty()) {
+			first();
+			(rest(), ...);
+			return;
+		}
+
+		uint64_t index = this->own_queue();
+		std::array<Task, sizeof...(Rest)> tasks;
+		uint64_t i = 0;
+		((tasks[i].run = &ThreadPool::call<std::remove_reference_t<Rest>>,
+		  tasks[i].function = const_cast<void*>(static_cast<const void*>(std::addressof(rest))), i++), ...);
+		for (Task& task : tasks) {
+			this->push(&task, index);
+		}
+
+		std::exception_ptr error;
+		try {
+			first();
+		} catch (...) {
+			error = std::current_exception();
+		}
+
+		for (uint64_t j = tasks.size(); j > 0; j--) {
+			this->join(&tasks[j - 1], index);
+		}
+		for (Task& task : tasks) {
+			if (!error) {
+				error = task.error;
+			}
+		}
+		if (error) {
+			std::rethrow_exception(error);
+		}
+	}
+
+	/* Calls function(begin, end) on subranges of at most grain elements covering [begin, end) */
+	template<typename Function>
+	void for_each(uint64_t begin, uint64_t end, uint64_t grain, const Function& function) {
+		if (end - begin <= grain || workers_.empty()) {
+			function(begin, end);
+			return;
+		}
+
+		uint64_t middle = begin + (end - begin) / 2;
+		this->invoke([&] { this->for_each(begin, middle, grain, function); },
+					 [&] { this->for_each(middle, end, grain, function); });
+	}
+};
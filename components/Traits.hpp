@@ -3,6 +3,9 @@
 template<typename T>
 concept Integer = std::is_integral_v<T>;
 
+/* Unsigned type as wide as T, make_unsigned rejects bool so it maps to unsigned char */
+template<Integer T> using unsigned_integer_t = std::make_unsigned_t<std::conditional_t<std::is_same_v<T, bool>, unsigned char, T>>;
+
 template<typename> struct next_integer_type;
 template<typename T> using next_integer_type_t = typename next_integer_type<T>::type;
 template<typename T> struct tag { using type = T; };
@@ -1,6 +1,16 @@
+#include <thread>
+#include <vector>
+#include <sstream>
+
 #include <gtest/gtest.h>
 
 #include <BigInteger.hpp>
+#include <ModContext.hpp>
+#include <BigIntegerArray.hpp>
+#include <BigIntegerView.hpp>
+#include <BigIntegerWriter.hpp>
+#include <FixedInteger.hpp>
+#include <BigAccumulator.hpp>
 
 TEST(Add, BigInteger) {
 	BigInteger num1("-59832563298473298659832743284483294732984733");
@@ -10,3 +20,795 @@ TEST(Add, BigInteger) {
 	ASSERT_EQ(result, expected_result);
 }
 
+
+TEST(Print, BigInteger) {
+	BigInteger num("-340282366920938463463374607431768211456000000000000000001");
+	std::ostringstream os;
+	os << num << ' ' << BigInteger() << ' ' << BigInteger(-5);
+	ASSERT_EQ(os.str(), "-340282366920938463463374607431768211456000000000000000001 0 -5");
+}
+
+TEST(Convert, BigInteger) {
+	std::string digits = "-";
+	for (int i = 0; i < 40000; i++) {
+		digits.push_back(static_cast<char>('0' + (i * 7 + i / 13) % 10));
+	}
+	digits[1] = '9';
+	BigInteger num(digits);
+	ASSERT_EQ(num.to_string(), digits);
+	ASSERT_EQ(BigInteger("-000000000000000000000000000000000000000000000").to_string(), "0");
+	ASSERT_EQ(BigInteger("0001" + std::string(1000, '0')) - 1, BigInteger(std::string(1000, '9')));
+
+	char buffer[24];
+	auto [end, error] = BigInteger(-1234567).to_chars(buffer, buffer + sizeof(buffer));
+	ASSERT_EQ(error, std::errc());
+	ASSERT_EQ(std::string(buffer, end), "-1234567");
+	ASSERT_EQ(num.to_chars(buffer, buffer + sizeof(buffer)).ec, std::errc::value_too_large);
+	ASSERT_THROW(BigInteger("12a3"), NumberFormatException);
+	ASSERT_THROW(BigInteger("-"), NumberFormatException);
+}
+
+TEST(Bitwise, BigInteger) {
+	BigInteger num1("340282366920938463463374607431768211455");
+	BigInteger num2("-18446744073709551616");
+	ASSERT_EQ(num1 & num2, BigInteger("340282366920938463444927863358058659840"));
+	ASSERT_EQ(num1 | num2, BigInteger("-1"));
+	ASSERT_EQ(num1 ^ num2, BigInteger("-340282366920938463444927863358058659841"));
+	ASSERT_EQ(~num2, BigInteger("18446744073709551615"));
+}
+
+TEST(Multiply, BigInteger) {
+	BigInteger num1("99999999999999999999");
+	BigInteger num2("-33333333333333333333");
+	BigInteger one = 1;
+	for (int i = 0; i < 10; i++) {
+		num1 = num1 * num1 + one;
+		num2 = num2 * num2 - num1;
+	}
+	num2 = num2 * num1 + num2;
+	ASSERT_EQ((num1 + one) * (num1 - one), num1 * num1 - one);
+	ASSERT_EQ(num1 * num2, num2 * num1);
+	ASSERT_EQ((num1 * num2) * num1, num1 * (num2 * num1));
+	ASSERT_EQ(num1 * num2 + num2, (num1 + one) * num2);
+}
+
+TEST(MultiplyNtt, BigInteger) {
+	BigInteger num1("-340282366920938463463374607431768211455");
+	BigInteger num2("18446744073709551617");
+	for (int i = 0; i < 9; i++) {
+		num1 = num1 * num1 - num2;
+		num2 = num2 * num1 + num2;
+	}
+	ASSERT_EQ(BigInteger::multiply_ntt(num1, num2), num1 * num2);
+	ASSERT_EQ(BigInteger::multiply_ntt(num2, num2), num2 * num2);
+	ASSERT_EQ(BigInteger::multiply_ntt(num1, num1) * num2, num1 * BigInteger::multiply_ntt(num2, num1));
+}
+
+TEST(Divide, BigInteger) {
+	BigInteger num1("-59832563298473298659832743284483294732984733");
+	BigInteger num2("57564636357843758437584375843");
+	ASSERT_EQ(num1 / num2, BigInteger("-1039397920044717"));
+	ASSERT_EQ(num1 % num2, BigInteger("-2610811393862717387638413302"));
+	ASSERT_EQ(num1 / 7, BigInteger("-8547509042639042665690391897783327818997819"));
+	ASSERT_EQ(num1 % 7, BigInteger("0"));
+
+	for (int i = 0; i < 7; i++) {
+		num1 = num1 * num1 + num2;
+		num2 = num2 * num2 - 1;
+	}
+	BigInteger remainder = num2 - 12345;
+	auto [quotient, rest] = BigInteger::divmod(num1 * num2 + remainder, num2);
+	ASSERT_EQ(quotient, num1);
+	ASSERT_EQ(rest, remainder);
+	ASSERT_THROW(num1 / BigInteger(), ArithmeticException);
+}
+
+TEST(Storage, BigInteger) {
+	BigInteger small(-12345);
+	BigInteger wide = BigInteger("340282366920938463463374607431768211456") * BigInteger("340282366920938463463374607431768211456");
+	BigInteger copy = wide;
+	BigInteger moved = std::move(copy);
+	ASSERT_EQ(moved, wide);
+	moved = small;
+	ASSERT_EQ(moved, BigInteger(-12345));
+	moved = std::move(wide);
+	ASSERT_EQ(moved.to_string(), "115792089237316195423570985008687907853269984665640564039457584007913129639936");
+	ASSERT_EQ(moved * moved / moved, moved);
+	ASSERT_EQ(small + moved - moved, small);
+}
+
+TEST(Assign, BigInteger) {
+	BigInteger a("-18446744073709551616");
+	a += a;
+	ASSERT_EQ(a, BigInteger("-36893488147419103232"));
+	a -= BigInteger("-36893488147419103233");
+	ASSERT_EQ(a, BigInteger(1));
+	a <<= 130;
+	ASSERT_EQ(a, BigInteger("1361129467683753853853498429727072845824"));
+	a *= BigInteger(-3);
+	a >>= 129;
+	ASSERT_EQ(a, BigInteger(-6));
+	a &= BigInteger(13);
+	ASSERT_EQ(a, BigInteger(8));
+	a ^= a;
+	ASSERT_EQ(a, BigInteger(0));
+	ASSERT_EQ(BigInteger(5) - BigInteger(12), BigInteger(-7));
+	ASSERT_EQ(a - BigInteger(12), BigInteger(-12));
+	ASSERT_EQ(-(BigInteger(7) << 64), BigInteger("-129127208515966861312"));
+}
+
+TEST(Expression, BigInteger) {
+	BigInteger num1("-340282366920938463463374607431768211455");
+	BigInteger num2("18446744073709551617");
+	BigInteger num3("-12345678901234567890");
+	BigInteger expected = BigInteger(num1) * num2 + BigInteger(num3) * num3 - num1;
+	ASSERT_EQ(num1 * num2 + num3 * num3 - num1, expected);
+	ASSERT_EQ(num1 - num2 * num3, BigInteger("-112544787813668649428467220519122433325"));
+
+	BigInteger sum = num3;
+	sum -= num1 * num1;
+	sum += num1 * num1;
+	ASSERT_EQ(sum, num3);
+	num1 = num1 * num2 - num1;
+	ASSERT_EQ(num1, BigInteger("-6277101735386680763835789423207666416083908700390324961280"));
+	ASSERT_EQ(num2 * num2 / num2, num2);
+}
+
+TEST(Allocator, BigInteger) {
+	BigInteger num1("-340282366920938463463374607431768211455");
+	BigInteger num2("18446744073709551617");
+	for (int i = 0; i < 6; i++) {
+		num1 = num1 * num1 - num2;
+	}
+	BigInteger expected = (num1 * num1 + num2) / num2;
+
+	LimbArena arena;
+	LimbPool pool;
+	BigInteger saved;
+	{
+		LimbResource::Scope arena_scope(arena);
+		BigInteger result = (num1 * num1 + num2) / num2;
+		ASSERT_EQ(result, expected);
+		{
+			LimbResource::Scope pool_scope(pool);
+			BigInteger copy = result;
+			ASSERT_EQ(copy * copy / result, result);
+		}
+		saved = std::move(result);
+	}
+	arena.release();
+	pool.release();
+	ASSERT_EQ(saved, expected);
+	ASSERT_EQ(LimbResource::current(), nullptr);
+}
+
+TEST(Shift, BigInteger) {
+	BigInteger one = 1;
+	BigInteger wide = (one << 10000) + 12345;
+	ASSERT_EQ(wide >> 9999, BigInteger(2));
+	ASSERT_EQ((wide << 77) >> 77, wide);
+	ASSERT_EQ(BigInteger(-5) >> 1, BigInteger(-3));
+	ASSERT_EQ(BigInteger(-4) >> 1, BigInteger(-2));
+	ASSERT_EQ(-wide >> 20000, BigInteger(-1));
+	ASSERT_EQ(BigInteger("-18446744073709551615") >> 64, BigInteger(-1));
+	ASSERT_EQ(BigInteger("-18446744073709551616") >> 64, BigInteger(-1));
+	ASSERT_EQ(BigInteger("-18446744073709551617") >> 64, BigInteger(-2));
+	ASSERT_EQ(BigInteger::pow(2, 10000), one << 10000);
+	ASSERT_EQ(BigInteger::pow(-3, 5), BigInteger(-243));
+	ASSERT_THROW(one << -1, ArithmeticException);
+	ASSERT_THROW(one >> BigInteger(-1), ArithmeticException);
+}
+
+TEST(ModContext, BigInteger) {
+	BigInteger one = 1;
+	BigInteger odd = (one << 521) - 1;
+	BigInteger even = (one << 300) + (one << 17);
+	BigInteger base = (one << 400) + 987654321;
+	for (const BigInteger& modulus : {odd, even, one << 64, one << 256, BigInteger(1), BigInteger(97)}) {
+		ModContext context(modulus);
+		ASSERT_EQ(context.is_montgomery(), modulus.to_string().back() % 2 == 1);
+		ASSERT_EQ(context.powmod(base, 0), BigInteger(modulus == 1 ? 0 : 1));
+		ASSERT_EQ(context.powmod(base, 37), BigInteger::pow(base, 37) % modulus);
+		ASSERT_EQ((context.powmod(-base, 37) + BigInteger::pow(base, 37)) % modulus, BigInteger(0));
+		ASSERT_EQ(context.mulmod(base, base + 5), base * (base + 5) % modulus);
+		ASSERT_EQ(context.sqrmod(-base), base * base % modulus);
+		ASSERT_EQ(context.reduce(-one), modulus - 1);
+	}
+
+	ModContext context(odd);
+	BigInteger exponent = odd - 1;
+	std::vector<BigInteger> bases = {2, 3, base};
+	for (const BigInteger& result : context.powmod(bases, exponent)) {
+		ASSERT_EQ(result, one);
+	}
+	std::vector<BigInteger> exponents = {521, 0, 1};
+	ASSERT_EQ(context.powmod(bases, exponents), (std::vector<BigInteger>{one, one, base % odd}));
+	ASSERT_THROW(context.powmod(base, -1), ArithmeticException);
+	ASSERT_THROW(context.powmod(bases, std::vector<BigInteger>{1}), ArithmeticException);
+	ASSERT_THROW(ModContext(BigInteger(0)), ArithmeticException);
+}
+
+TEST(Roots, BigInteger) {
+	BigInteger base("123456789012345678901234567890");
+	BigInteger power = BigInteger::pow(base, 37);
+	ASSERT_EQ(power, BigInteger::pow(base, BigInteger(37)));
+	ASSERT_EQ(BigInteger::pow(-base, 3), -(base * base * base));
+	ASSERT_EQ(BigInteger::pow(BigInteger(-1), BigInteger(1) << 100), BigInteger(1));
+	ASSERT_THROW(BigInteger::pow(base, -1), ArithmeticException);
+	ASSERT_THROW(BigInteger::pow(base, BigInteger(1) << 64), ArithmeticException);
+
+	ASSERT_EQ(BigInteger::isqrt(power * power), power);
+	ASSERT_EQ(BigInteger::isqrt(power * power - 1), power - 1);
+	ASSERT_EQ(BigInteger::iroot(power, 37), base);
+	ASSERT_EQ(BigInteger::iroot(power - 1, 37), base - 1);
+	ASSERT_EQ(BigInteger::iroot(-power, 37), -base);
+	ASSERT_EQ(BigInteger::iroot(BigInteger(80), 4), BigInteger(2));
+	ASSERT_EQ(BigInteger::iroot(BigInteger(1000), 1ULL << 63), BigInteger(1));
+	ASSERT_EQ(BigInteger::iroot(BigInteger(1000), 1ULL << 40), BigInteger(1));
+	ASSERT_EQ(BigInteger::iroot(BigInteger(-1000), std::numeric_limits<uint64_t>::max()), BigInteger(-1));
+	ASSERT_EQ(BigInteger::iroot(BigInteger(1) << 100, 100), BigInteger(2));
+	ASSERT_EQ(BigInteger::iroot((BigInteger(1) << 100) - 1, 100), BigInteger(1));
+	ASSERT_THROW(BigInteger::isqrt(BigInteger(-4)), ArithmeticException);
+	ASSERT_THROW(BigInteger::iroot(base, 0), ArithmeticException);
+
+	ASSERT_TRUE(BigInteger::is_perfect_power(power));
+	ASSERT_TRUE(BigInteger::is_perfect_power(-power));
+	ASSERT_TRUE(BigInteger::is_perfect_power(BigInteger(1) << 90));
+	ASSERT_TRUE(BigInteger::is_perfect_power(BigInteger(-8)));
+	ASSERT_FALSE(BigInteger::is_perfect_power(power + 1));
+	ASSERT_FALSE(BigInteger::is_perfect_power(BigInteger(-4)));
+	ASSERT_FALSE(BigInteger::is_perfect_power(BigInteger(2) * BigInteger::pow(3, 40)));
+}
+
+TEST(Gcd, BigInteger) {
+	ASSERT_EQ(BigInteger::gcd(BigInteger(0), BigInteger(0)), BigInteger(0));
+	ASSERT_EQ(BigInteger::gcd(BigInteger(-12), BigInteger(18)), BigInteger(6));
+	ASSERT_EQ(BigInteger::lcm(BigInteger(-4), BigInteger(6)), BigInteger(12));
+	ASSERT_EQ(BigInteger::lcm(BigInteger(0), BigInteger(6)), BigInteger(0));
+
+	/* Large enough for the half gcd, consecutive numbers share no factor */
+	BigInteger common = BigInteger::pow(7, 3000) + 2;
+	BigInteger first = BigInteger::pow(3, 20000);
+	BigInteger second = first + 1;
+	ASSERT_EQ(BigInteger::gcd(first * common, second * common), common);
+	ASSERT_EQ(BigInteger::gcd(-first * common, common), common);
+	ASSERT_EQ(BigInteger::lcm(first * common, second * common), first * second * common);
+
+	std::vector<std::pair<BigInteger, BigInteger>> pairs = {{first * common, -second * common}, {240, 46}, {0, -5}, {-5, 0}};
+	for (const auto& [a, b] : pairs) {
+		auto [g, s, t] = BigInteger::gcdext(a, b);
+		ASSERT_EQ(g, BigInteger::gcd(a, b));
+		ASSERT_EQ(s * a + t * b, g);
+		if (b != 0) {
+			ASSERT_LE(BigInteger::abs(s) * 2 * g, BigInteger::abs(b));
+		}
+	}
+
+	BigInteger modulus = (BigInteger(1) << 521) - 1;
+	BigInteger inverse = BigInteger::modinv(-first, modulus);
+	ASSERT_EQ((inverse * -first % modulus + modulus) % modulus, BigInteger(1));
+	ASSERT_EQ(BigInteger::modinv(BigInteger(3), BigInteger(-7)), BigInteger(5));
+	ASSERT_THROW(BigInteger::modinv(BigInteger(6), BigInteger(9)), ArithmeticException);
+	ASSERT_THROW(BigInteger::modinv(BigInteger(6), BigInteger(0)), ArithmeticException);
+}
+
+TEST(Parallel, BigInteger) {
+	ThreadPool pool(4);
+	int value = 0;
+	pool.invoke([&] { value += 1; }, [] {}, [] {});
+	ASSERT_EQ(value, 1);
+	ASSERT_THROW(pool.invoke([] {}, [] { throw ArithmeticException("Task failed."); }), ArithmeticException);
+
+	/* Toom-3 branches around 2000 limbs, unbalanced blocks and the transforms from 5000 limbs up */
+	BigInteger toom = BigInteger::pow(3, 80000) - 1;
+	BigInteger ntt = -BigInteger::pow(7, 200000) + 5;
+	BigInteger small = BigInteger::pow(5, 1000);
+	std::vector<std::pair<BigInteger, BigInteger>> pairs = {{toom, toom}, {toom, -toom + 7}, {ntt, toom}, {ntt, ntt},
+															 {ntt, ntt * 3 + 1}, {small, toom}, {0, ntt}};
+	for (const auto& [a, b] : pairs) {
+		BigInteger expected = BigInteger::multiply(a, b, std::execution::seq);
+		ASSERT_EQ(BigInteger::multiply(a, b, pool), expected);
+		ASSERT_EQ(BigInteger::multiply(a, b, std::execution::par), expected);
+		ASSERT_EQ(a * b, expected);
+	}
+
+	/* The recursive division multiplies blocks of half the divisor and more, balanced and with a long quotient */
+	for (const auto& [dividend, divisor] : std::vector<std::pair<BigInteger, BigInteger>>{{ntt, -toom}, {ntt * ntt + 3, ntt - 1}}) {
+		auto expected = BigInteger::divmod(dividend, divisor);
+		ASSERT_EQ(BigInteger::divmod(dividend, divisor, pool), expected);
+		ASSERT_EQ(BigInteger::divmod(dividend, divisor, std::execution::par), expected);
+		ASSERT_EQ(BigInteger::divmod(dividend, divisor, std::execution::seq), expected);
+	}
+}
+
+TEST(Array, BigInteger) {
+	BigInteger large = BigInteger::pow(3, 500);
+	std::vector<BigInteger> first = {0, 5, -5, large, -large, large + 1, 7, (BigInteger(1) << 64) - 1};
+	std::vector<BigInteger> second = {0, -5, -7, -large, large, large, 0, 1};
+	std::vector<int64_t> factors = {3, 0, -2, INT64_MIN, 7, -1, 1, 2};
+	BigIntegerArray numbers(first), others(second);
+	ASSERT_EQ(numbers.size(), first.size());
+	ASSERT_EQ(numbers.to_vector(), first);
+
+	ThreadPool pool(3);
+	BigIntegerArray sums = BigIntegerArray::add(numbers, others, pool);
+	BigIntegerArray differences = BigIntegerArray::sub(numbers, others, std::execution::par);
+	BigIntegerArray products = BigIntegerArray::mul_scalar(numbers, factors);
+	BigIntegerArray doubled = BigIntegerArray::mul_scalar(numbers, -2, pool);
+	std::vector<int32_t> comparisons = BigIntegerArray::compare(numbers, others);
+	std::vector<int32_t> signs = BigIntegerArray::compare(numbers, BigInteger(0), pool);
+	std::vector<std::string> digits = numbers.to_string(pool);
+	for (uint64_t i = 0; i < first.size(); i++) {
+		ASSERT_EQ(sums[i], first[i] + second[i]);
+		ASSERT_EQ(differences[i], first[i] - second[i]);
+		ASSERT_EQ(products[i], first[i] * factors[i]);
+		ASSERT_EQ(doubled[i], first[i] * -2);
+		ASSERT_EQ(comparisons[i], first[i] < second[i] ? -1 : first[i] == second[i] ? 0 : 1);
+		ASSERT_EQ(signs[i], first[i] < 0 ? -1 : first[i] == 0 ? 0 : 1);
+		ASSERT_EQ(digits[i], first[i].to_string());
+	}
+	ASSERT_FALSE(sums.is_negative(1));
+	ASSERT_TRUE(sums.limbs(4).empty());
+
+	others.push_back(1);
+	ASSERT_THROW(BigIntegerArray::add(numbers, others), ArithmeticException);
+}
+
+TEST(Kernels, BigInteger) {
+	using unit_type = LimbKernels::unit_type;
+	uint64_t seed = 1;
+	auto next = [&seed] {
+		seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+		/* Runs of all ones push carries through whole chains */
+		return (seed >> 61) == 0 ? ~static_cast<unit_type>(0) : seed ^ (seed >> 29);
+	};
+
+	for (uint64_t n = 0; n <= 70; n++) {
+		std::vector<unit_type> a(n), b(n), expected(n), actual(n);
+		std::generate(a.begin(), a.end(), next);
+		std::generate(b.begin(), b.end(), next);
+		unit_type factor = next();
+		ASSERT_EQ(LimbKernels::add_n(actual.data(), a.data(), b.data(), n),
+				  LimbKernels::add_n_portable(expected.data(), a.data(), b.data(), n));
+		ASSERT_EQ(actual, expected);
+		ASSERT_EQ(LimbKernels::sub_n(actual.data(), a.data(), b.data(), n),
+				  LimbKernels::sub_n_portable(expected.data(), a.data(), b.data(), n));
+		ASSERT_EQ(actual, expected);
+		/* Callers that drop the borrow still need the difference */
+		actual = a;
+		static_cast<void>(LimbKernels::sub_n(actual.data(), actual.data(), b.data(), n));
+		ASSERT_EQ(actual, expected);
+		ASSERT_EQ(LimbKernels::mul_1(actual.data(), a.data(), n, factor),
+				  LimbKernels::mul_1_portable(expected.data(), a.data(), n, factor));
+		ASSERT_EQ(actual, expected);
+		ASSERT_EQ(LimbKernels::addmul_1(actual.data(), b.data(), n, factor),
+				  LimbKernels::addmul_1_portable(expected.data(), b.data(), n, factor));
+		ASSERT_EQ(actual, expected);
+		ASSERT_EQ(LimbKernels::submul_1(actual.data(), a.data(), n, factor),
+				  LimbKernels::submul_1_portable(expected.data(), a.data(), n, factor));
+		ASSERT_EQ(actual, expected);
+	}
+
+	/* Covers the vector products where the processor has them */
+	for (uint64_t an = 16; an <= 72; an += 7) {
+		for (uint64_t bn = 16; bn <= an; bn += 9) {
+			std::vector<unit_type> a(an), b(bn), expected(an + bn), actual(an + bn);
+			std::generate(a.begin(), a.end(), next);
+			std::generate(b.begin(), b.end(), next);
+			expected[an] = LimbKernels::mul_1_portable(expected.data(), a.data(), an, b[0]);
+			for (uint64_t i = 1; i < bn; i++) {
+				expected[an + i] = LimbKernels::addmul_1_portable(expected.data() + i, a.data(), an, b[i]);
+			}
+			LimbKernels::mul_basecase(actual.data(), a.data(), an, b.data(), bn);
+			ASSERT_EQ(actual, expected);
+			Multiplication::mul(actual.data(), a.data(), an, b.data(), bn);
+			ASSERT_EQ(actual, expected);
+		}
+	}
+}
+
+TEST(Serialize, BigInteger) {
+	using Format = Serialization::Format;
+	BigInteger large = -BigInteger::pow(3, 300);
+	for (const BigInteger& number : {BigInteger(), BigInteger(127), BigInteger(-128), large, (BigInteger(1) << 64) - 1}) {
+		for (Format format : {Format::fixed, Format::compact}) {
+			std::vector<std::byte> bytes = number.serialize(format);
+			ASSERT_EQ(bytes.size(), number.serialized_size(format));
+			ASSERT_EQ(BigInteger::deserialize(bytes), number);
+			ASSERT_EQ(Serialization::read_header(bytes).size, bytes.size());
+		}
+	}
+	ASSERT_EQ(BigInteger(127).serialized_size(Format::compact), 3);
+	ASSERT_EQ(BigInteger(128).serialized_size(Format::compact), 4);
+
+	std::vector<std::byte> bytes = BigInteger(300).serialize(Format::compact);
+	ASSERT_THROW(BigInteger::deserialize(std::span(bytes).first(3)), NumberFormatException);
+	bytes.back() = std::byte{0};
+	ASSERT_THROW(BigInteger::deserialize(bytes), NumberFormatException);
+	bytes = large.serialize();
+	bytes[2] = std::byte{1};
+	ASSERT_THROW(BigInteger::deserialize(bytes), NumberFormatException);
+	std::array<std::byte, 4> small;
+	ASSERT_THROW(large.serialize(small), ArithmeticException);
+
+	/* Two encodings back to back in a buffer aligned like an mmapped file */
+	std::vector<uint64_t> buffer(large.serialized_size() / 8 + 3);
+	std::span<std::byte> out = std::as_writable_bytes(std::span(buffer));
+	uint64_t offset = large.serialize(out);
+	BigInteger(5).serialize(out.subspan(offset));
+	BigIntegerView view = BigIntegerView::from_bytes(out);
+	BigIntegerView five = BigIntegerView::from_bytes(out.subspan(offset));
+	ASSERT_EQ(view.data(), buffer.data() + 2);
+	ASSERT_EQ(BigInteger(view), large);
+	ASSERT_TRUE(view == large && large == view && view < five && BigInteger(4) < five);
+	ASSERT_EQ(BigInteger(7) + five, BigInteger(12));
+	ASSERT_EQ(BigInteger(7) - view, BigInteger(7) - large);
+	ASSERT_EQ(large * view, large * large);
+	ASSERT_EQ(BigInteger::pow(large, 2) / view, large);
+	ASSERT_EQ(BigInteger(17) % five, BigInteger(2));
+	BigInteger sum = 1;
+	sum += view;
+	sum *= five;
+	ASSERT_EQ(sum, (large + 1) * 5);
+	ASSERT_THROW(static_cast<void>(BigIntegerView::from_bytes(out.subspan(1))), NumberFormatException);
+	ASSERT_THROW(static_cast<void>(BigIntegerView::from_bytes(BigInteger(5).serialize(Format::compact))), NumberFormatException);
+}
+
+TEST(Stream, BigInteger) {
+	/* Enough digits for several joined blocks and a partial one */
+	BigInteger large = -(BigInteger::pow(7, 30000) + 12345);
+	std::string digits = large.to_string();
+
+	BigIntegerReader reader;
+	for (uint64_t i = 0; i < digits.size(); i += 1000) {
+		reader.feed(std::string_view(digits).substr(i, 1000));
+	}
+	ASSERT_EQ(BigInteger(reader.finish()), large);
+	reader.feed("000000000000000000000000000000000000000000000");
+	ASSERT_EQ(BigInteger(reader.finish()), BigInteger());
+	reader.feed("-");
+	ASSERT_THROW(static_cast<void>(reader.finish()), NumberFormatException);
+	ASSERT_THROW(reader.feed("12a"), NumberFormatException);
+
+	std::string text;
+	BigIntegerWriter writer(1000);
+	uint64_t pieces = 0;
+	writer.write(large.view(), [&](std::string_view piece) {
+		ASSERT_LE(piece.size(), writer.chunk());
+		text += piece;
+		pieces += 1;
+	});
+	ASSERT_EQ(text, digits);
+	ASSERT_GT(pieces, digits.size() / writer.chunk());
+	std::ostringstream written;
+	writer.write(large.view(), written);
+	ASSERT_EQ(written.str(), digits);
+	ASSERT_EQ(BigInteger(BigInteger::pow(10, 5000).to_string()), BigInteger::pow(10, 5000));
+
+	/* Large enough to stream in pieces on the way out */
+	BigInteger huge = BigInteger::pow(3, 300000) * 10000000;
+	std::stringstream stream;
+	stream << "  " << large << ' ' << huge << " -x 17";
+	BigInteger first, second, third;
+	stream >> first >> second;
+	ASSERT_EQ(first, large);
+	ASSERT_EQ(second, huge);
+	ASSERT_FALSE(stream >> third);
+	stream.clear();
+	stream.ignore(1);
+	ASSERT_TRUE(stream >> third);
+	ASSERT_EQ(third, BigInteger(17));
+	ASSERT_TRUE(stream.eof());
+}
+
+TEST(Fixed, BigInteger) {
+	static_assert(Int256(-7) / 2 == -3 && Int256(-7) % 2 == -1 && (UInt256(1) << 255 >> 254) == 2);
+	static_assert(-Int128::min() == Int128::min() && Int128::max() + 1 == Int128::min() && UInt128(0) - 1 == UInt128::max());
+	static_assert(Int128(true) == 1 && UInt256(false) == 0);
+
+	/* Every result has to be the BigInteger one modulo 2^256 */
+	uint64_t seed = 1;
+	auto random = [&seed](uint64_t limbs) {
+		BigInteger result;
+		for (uint64_t i = 0; i < limbs; i++) {
+			seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+			result = (result << 64) + (seed >> (seed % 64));
+		}
+		return seed % 3 == 0 ? -result : result;
+	};
+	for (uint64_t i = 0; i < 500; i++) {
+		BigInteger a = random(i % 4 + 1), b = random(i % 3 + 1);
+		ASSERT_EQ(static_cast<BigInteger>(Int256(b)), b);
+		Int256 x(a), y(b);
+		ASSERT_EQ(x + y, Int256(a + b));
+		ASSERT_EQ(x - y, Int256(a - b));
+		ASSERT_EQ(x * y, Int256(a * b));
+		ASSERT_EQ(x < y, a < b);
+		ASSERT_EQ(x << (i % 300), Int256(a << (i % 300)));
+		ASSERT_EQ(UInt256(a) * UInt256(b), UInt256(a * b));
+		ASSERT_EQ(UInt256(a) < UInt256(b), static_cast<BigInteger>(UInt256(a)) < static_cast<BigInteger>(UInt256(b)));
+		if (b == 0) {
+			continue;
+		}
+		ASSERT_EQ(x / y, Int256(a / b));
+		ASSERT_EQ(x % y, Int256(a % b));
+		if (a >= 0 && b > 0) {
+			ASSERT_EQ(UInt256(a) / UInt256(b), UInt256(a / b));
+			ASSERT_EQ(x >> (i % 300), Int256(a >> (i % 300)));
+		}
+	}
+
+	ASSERT_EQ(Int256(-1) >> 1000, Int256(-1));
+	ASSERT_EQ(Int256(-256) >> 4, Int256(-16));
+	ASSERT_EQ(UInt256(-1) >> 192, UInt256(UINT64_MAX));
+	ASSERT_EQ(static_cast<int64_t>(Int512(-5) * Int512(3)), -15);
+	ASSERT_EQ(static_cast<BigInteger>(UInt128(-1)), (BigInteger(1) << 128) - 1);
+	ASSERT_EQ(static_cast<BigInteger>(Int128::min()), -(BigInteger(1) << 127));
+	ASSERT_THROW(static_cast<void>(Int256(5) / 0), ArithmeticException);
+
+	std::stringstream stream;
+	Int1024 factorial = 1;
+	BigInteger expected = 1;
+	for (int32_t i = 2; i <= 100; i++) {
+		factorial *= i;
+		expected *= i;
+	}
+	stream << -factorial;
+	ASSERT_EQ(stream.str(), (-expected).to_string());
+}
+
+TEST(Instrumentation, BigInteger) {
+	using Operation = Instrumentation::Operation;
+	Instrumentation::reset();
+	BigInteger a = BigInteger::pow(3, 20000);
+	BigInteger b = a * (a + 1);
+	BigInteger q = b / a;
+	ASSERT_EQ(q, a + 1);
+	ASSERT_TRUE((a & b) <= b);
+
+	Instrumentation::Snapshot stats = BigInteger::stats();
+	std::string json = stats.to_json();
+	if constexpr (Instrumentation::enabled) {
+		uint64_t limbs = a.view().size();
+		ASSERT_EQ(stats[Operation::power].calls, 1);
+		ASSERT_EQ(stats[Operation::divide].calls, 1);
+		ASSERT_EQ(stats[Operation::divide].sizes[std::bit_width(b.view().size())], 1);
+		ASSERT_GE(stats[Operation::multiply].calls, 2);
+		ASSERT_GE(stats[Operation::multiply].sizes[std::bit_width(limbs)], 1);
+		ASSERT_GE(stats[Operation::toom3].calls, 1);
+		ASSERT_GT(stats[Operation::multiply].bytes, 0);
+		ASSERT_GT(stats[Operation::divide].nanoseconds, 0);
+		ASSERT_EQ(stats[Operation::bitwise].calls, 1);
+		ASSERT_EQ(stats[Operation::print].calls, 0);
+		ASSERT_TRUE(json.starts_with("{\"enabled\":true,\"operations\":{\"add\":{\"calls\":"));
+		ASSERT_NE(json.find("\"divide\":{\"calls\":1,"), std::string::npos);
+		ASSERT_EQ(json.find("\"print\""), std::string::npos);
+
+		Instrumentation::reset();
+		ASSERT_EQ(BigInteger::stats()[Operation::divide].calls, 0);
+	} else {
+		ASSERT_EQ(stats[Operation::multiply].calls, 0);
+		ASSERT_EQ(json, "{\"enabled\":false,\"operations\":{}}");
+	}
+}
+
+TEST(Share, BigInteger) {
+	const BigInteger large = BigInteger::pow(7, 1000);
+	BigInteger copy = large;
+	BigInteger negated = -large;
+	ASSERT_EQ(copy.view().data(), large.view().data());
+	ASSERT_EQ(negated.view().data(), large.view().data());
+	ASSERT_EQ(BigInteger::abs(negated).view().data(), large.view().data());
+
+	/* Writing to one owner leaves the others alone */
+	copy += 1;
+	negated <<= 3;
+	ASSERT_NE(copy.view().data(), large.view().data());
+	ASSERT_EQ(copy - 1, large);
+	ASSERT_EQ(negated, -large * 8);
+	ASSERT_EQ(large, BigInteger::pow(7, 1000));
+
+	/* Copies of a buffer with room to spare grow into buffers of their own, within and past that room */
+	BigInteger roomy = large << 10000;
+	roomy >>= 10000;
+	for (int64_t shift : {3000, 20000}) {
+		BigInteger grown = roomy;
+		BigInteger shifted = roomy;
+		ASSERT_EQ(grown.view().data(), roomy.view().data());
+		grown += large * large;
+		shifted <<= shift;
+		ASSERT_EQ(grown, large + large * large);
+		ASSERT_EQ(shifted, large * BigInteger::pow(2, shift));
+		ASSERT_EQ(roomy, large);
+	}
+
+	/* A copy assigned into a buffer of its own keeps that buffer */
+	BigInteger target = large * 3;
+	const uint64_t* buffer = target.view().data();
+	target = large;
+	ASSERT_EQ(target.view().data(), buffer);
+
+	/* Copies made under another resource do not share, they must not outlive it */
+	LimbArena arena;
+	{
+		LimbResource::Scope scope(arena);
+		BigInteger local = large;
+		ASSERT_NE(local.view().data(), large.view().data());
+		ASSERT_EQ(local, large);
+	}
+	arena.release();
+
+	std::vector<std::thread> threads;
+	std::vector<BigInteger> results(4);
+	for (uint64_t i = 0; i < results.size(); i++) {
+		threads.emplace_back([&large, &results, i] {
+			for (uint64_t j = 0; j < 1000; j++) {
+				BigInteger shared = large;
+				shared += i;
+				results[i] = shared;
+			}
+		});
+	}
+	for (std::thread& thread : threads) {
+		thread.join();
+	}
+	for (uint64_t i = 0; i < results.size(); i++) {
+		ASSERT_EQ(results[i], large + i);
+	}
+}
+
+TEST(Scalar, BigInteger) {
+	const BigInteger large = BigInteger::pow(-3, 301);
+	const std::vector<int64_t> values = {1, -1, 7, -7, 1000000007, std::numeric_limits<int64_t>::max(), std::numeric_limits<int64_t>::min()};
+	for (const BigInteger& number : {BigInteger(0), BigInteger(5), BigInteger(-12345), large, BigInteger::abs(large)}) {
+		for (int64_t value : values) {
+			BigInteger converted = value;
+			ASSERT_EQ(number + value, number + converted);
+			ASSERT_EQ(number - value, number - converted);
+			ASSERT_EQ(BigInteger(number * value), BigInteger(number * converted));
+			ASSERT_EQ(number / value, number / converted);
+			ASSERT_EQ(number % value, number % converted);
+			ASSERT_EQ(value - number, converted - number);
+			ASSERT_EQ(value * number, BigInteger(converted * number));
+			ASSERT_EQ(number == value, number == converted);
+			ASSERT_EQ(number <=> value, number <=> converted);
+			ASSERT_EQ(value < number, converted < number);
+		}
+	}
+
+	/* Every width of built in integer, including the two limb ones */
+	__int128_t wide = static_cast<__int128_t>(std::numeric_limits<int64_t>::min()) * 3;
+	ASSERT_EQ(large + wide, large + BigInteger(wide));
+	ASSERT_EQ(large / wide, large / BigInteger(wide));
+	ASSERT_EQ(large % static_cast<__uint128_t>(wide), large % BigInteger(static_cast<__uint128_t>(wide)));
+	ASSERT_EQ(BigInteger(-300) * int8_t(-128), 38400);
+	ASSERT_EQ(BigInteger(-300) / uint16_t(7), -42);
+	ASSERT_EQ(BigInteger(-300) % 7U, -6);
+	ASSERT_EQ(1000 / BigInteger(-7), -142);
+
+	BigInteger flag(true);
+	flag += true;
+	ASSERT_EQ(flag, 2);
+	ASSERT_EQ(BigInteger(false), 0);
+	ASSERT_TRUE(BigInteger(1) == true);
+	ASSERT_EQ(large * false, 0);
+	ASSERT_THROW(large / 0, ArithmeticException);
+	ASSERT_THROW(large % 0U, ArithmeticException);
+
+	/* Carries and borrows across limbs, and through zero */
+	BigInteger counter = std::numeric_limits<uint64_t>::max();
+	ASSERT_EQ(++counter, BigInteger(1) << 64);
+	ASSERT_EQ(counter--, BigInteger(1) << 64);
+	ASSERT_EQ(counter, std::numeric_limits<uint64_t>::max());
+	BigInteger small = 1;
+	ASSERT_EQ(--small, 0);
+	ASSERT_EQ(--small, -1);
+	ASSERT_EQ(small -= 4, -5);
+	ASSERT_EQ(small += 9, 4);
+
+	/* In place operations that fit the limbs stay in them */
+	BigInteger number = BigInteger::abs(large) * 5;
+	const uint64_t* limbs = number.view().data();
+	number -= 9;
+	number /= 7;
+	number *= 7;
+	number += 1;
+	ASSERT_EQ(number.view().data(), limbs);
+	number %= 1000000007;
+	ASSERT_EQ(number, (BigInteger::abs(large) * 5 - 9) / 7 * 7 + 1 - ((BigInteger::abs(large) * 5 - 9) / 7 * 7 + 1) / 1000000007 * 1000000007);
+}
+
+TEST(Bits, BigInteger) {
+	const BigInteger large = BigInteger::pow(3, 200) << 70;
+	for (const BigInteger& number : {BigInteger(0), BigInteger(1), BigInteger(-1), BigInteger(-128), BigInteger(1) << 128,
+									 -(BigInteger(1) << 128), large, -large, large + 1, -large - 1}) {
+		/* Every query agrees with the shifts and masks of the two's complement form */
+		for (uint64_t bit : {0, 1, 7, 63, 64, 65, 69, 70, 71, 127, 128, 129, 300, 500}) {
+			BigInteger mask = BigInteger(1) << bit;
+			ASSERT_EQ(number.test_bit(bit), ((number >> bit) & 1) == 1);
+
+			BigInteger changed = number;
+			changed.set_bit(bit);
+			ASSERT_EQ(changed, number | mask);
+			changed = number;
+			changed.clear_bit(bit);
+			ASSERT_EQ(changed, number & ~mask);
+
+			for (uint64_t width : {0, 1, 13, 64, 100, 200}) {
+				ASSERT_EQ(number.extract_bits(bit, bit + width), (number >> bit) & ((BigInteger(1) << width) - 1));
+			}
+		}
+
+		const BigInteger& magnitude = number < 0 ? ~number : number;
+		uint64_t count = 0;
+		for (uint64_t bit = 0; bit < 1000; bit++) {
+			count += magnitude.test_bit(bit);
+		}
+		ASSERT_EQ(number.popcount(), count);
+		ASSERT_EQ(number.bit_length(), magnitude.bit_length());
+	}
+
+	ASSERT_EQ(BigInteger(-128).bit_length(), 7);
+	ASSERT_EQ(BigInteger(128).bit_length(), 8);
+	ASSERT_EQ(large.bit_length(), 387);
+	ASSERT_EQ(large.countr_zero(), 70);
+	ASSERT_EQ((-large).countr_zero(), 70);
+	ASSERT_EQ(BigInteger(0).countr_zero(), std::numeric_limits<uint64_t>::max());
+	ASSERT_EQ(BigInteger(-1).popcount(), 0);
+	ASSERT_THROW(large.extract_bits(10, 9), ArithmeticException);
+}
+
+TEST(Accumulator, BigInteger) {
+	std::vector<BigInteger> numbers;
+	BigInteger term = BigInteger::pow(-7, 150);
+	for (uint64_t i = 0; i < 20000; i++) {
+		term = term * -3 + i;
+		if (term.bit_length() > 5000) {
+			term = (term >> 4900) - 12345;
+		}
+		numbers.push_back(term);
+	}
+
+	BigInteger expected;
+	BigAccumulator accumulator;
+	for (uint64_t i = 0; i < numbers.size(); i++) {
+		expected += numbers[i];
+		accumulator.add(numbers[i]);
+		if (i % 97 == 0) {
+			int64_t value = i % 2 == 0 ? std::numeric_limits<int64_t>::min() : std::numeric_limits<int64_t>::max();
+			expected += value;
+			accumulator.add(value);
+			expected -= ~uint64_t(0);
+			accumulator.add(BigInteger(~uint64_t(0)) * -1);
+		}
+		if (i % 500 == 0) {
+			const BigInteger& other = numbers[(i * 7) % numbers.size()];
+			expected += numbers[i] * other;
+			accumulator.add_product(numbers[i], other);
+			expected += numbers[i] * -5;
+			accumulator.add_product(numbers[i], BigInteger(-5));
+		}
+	}
+	ASSERT_EQ(accumulator.result(), expected);
+
+	/* The total stays valid as terms are added after it was taken */
+	accumulator.add(-expected);
+	ASSERT_EQ(accumulator.result(), 0);
+
+	BigInteger total;
+	for (const BigInteger& number : numbers) {
+		total += number;
+	}
+	ThreadPool pool(4);
+	ASSERT_EQ(BigAccumulator::sum(numbers), total);
+	ASSERT_EQ(BigAccumulator::sum(numbers, pool), total);
+	ASSERT_EQ(BigAccumulator::sum(numbers, std::execution::par), total);
+
+	BigAccumulator first, second;
+	first.add(std::span(numbers).first(5000));
+	second.add(std::span(numbers).subspan(5000));
+	first.merge(second);
+	ASSERT_EQ(first.result(), total);
+	first.clear();
+	ASSERT_EQ(first.result(), 0);
+}